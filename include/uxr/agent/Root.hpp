@@ -16,6 +16,7 @@
 #define _UXR_AGENT_ROOT_HPP_
 
 #include <uxr/agent/client/ProxyClient.hpp>
+#include <uxr/agent/utils/TokenBucket.hpp>
 #include <thread>
 #include <memory>
 #include <map>
@@ -40,6 +41,7 @@ public:
 
 private:
     std::mutex mtx_;
+    std::shared_ptr<utils::TokenBucket> link_budget_;
     std::map<dds::xrce::ClientKey, std::shared_ptr<ProxyClient>> clients_;
     std::map<dds::xrce::ClientKey, std::shared_ptr<ProxyClient>>::iterator current_client_;
 };
@@ -17,7 +17,11 @@
 
 #include <uxr/agent/participant/Participant.hpp>
 #include <uxr/agent/client/session/Session.hpp>
+#include <uxr/agent/utils/TokenBucket.hpp>
+#include <uxr/agent/scheduler/Executor.hpp>
 #include <unordered_map>
+#include <map>
+#include <set>
 #include <array>
 
 namespace eprosima {
@@ -26,8 +30,9 @@ namespace uxr {
 class ProxyClient
 {
 public:
-    explicit ProxyClient(const dds::xrce::CLIENT_Representation& representation);
-    ~ProxyClient() = default;
+    explicit ProxyClient(const dds::xrce::CLIENT_Representation& representation,
+                         const std::shared_ptr<utils::TokenBucket>& link_budget = nullptr);
+    ~ProxyClient();
 
     ProxyClient(const ProxyClient&) = delete;
     ProxyClient(ProxyClient&&) = delete;
@@ -44,6 +49,13 @@ public:
     XRCEObject* get_object(const dds::xrce::ObjectId& object_id);
     const dds::xrce::ClientKey& get_client_key() const { return representation_.client_key(); }
     dds::xrce::SessionId get_session_id() const { return representation_.session_id(); }
+    bool keep_latest() const { return keep_latest_; }
+    const std::shared_ptr<utils::TokenBucket>& budget() const { return budget_; }
+    void wait_output_window(dds::xrce::StreamId stream_id, const dds::xrce::ObjectId& object_id);
+    std::vector<dds::xrce::ObjectId> take_output_window_waiters(dds::xrce::StreamId stream_id);
+    bool heartbeat_armed(dds::xrce::StreamId stream_id);
+    void arm_heartbeat(dds::xrce::StreamId stream_id, Executor::TimerId timer_id);
+    void disarm_heartbeat(dds::xrce::StreamId stream_id);
     Session& session();
 
 private:
@@ -63,6 +75,12 @@ private:
 
 private:
     dds::xrce::CLIENT_Representation representation_;
+    bool keep_latest_;
+    std::shared_ptr<utils::TokenBucket> budget_;
+    std::mutex waiters_mtx_;
+    std::map<dds::xrce::StreamId, std::set<dds::xrce::ObjectId>> output_window_waiters_;
+    std::mutex heartbeat_mtx_;
+    std::map<dds::xrce::StreamId, Executor::TimerId> heartbeat_timers_;
     std::mutex mtx_;
     ObjectContainer objects_;
     Session session_;
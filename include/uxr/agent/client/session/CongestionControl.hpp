@@ -0,0 +1,117 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_CLIENT_SESSION_CONGESTION_CONTROL_HPP_
+#define _UXR_AGENT_CLIENT_SESSION_CONGESTION_CONTROL_HPP_
+
+#include <uxr/agent/config.hpp>
+#include <uxr/agent/utils/SeqNum.hpp>
+#include <algorithm>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * @brief The CongestionControl class keeps the AIMD congestion window, in messages, of a reliable
+ *        output stream: slow start up to ssthresh, then one more message per window acknowledged.
+ *        A NACK halves the window once per window of data, and an unanswered HEARTBEAT (timeout)
+ *        shrinks it to a single message.
+ */
+class CongestionControl
+{
+public:
+    CongestionControl() { reset(); }
+
+    void reset();
+    uint16_t window() const { return cwnd_; }
+    uint16_t threshold() const { return ssthresh_; }
+
+    void on_ack(uint16_t acked, SeqNum first_unacked);
+    void on_loss(SeqNum lost, SeqNum last_sent);
+    void on_timeout(SeqNum last_sent);
+
+private:
+    static constexpr uint16_t initial_window_ = 2;
+
+    uint16_t cwnd_;
+    uint16_t ssthresh_;
+    uint16_t acked_;
+    bool in_recovery_;
+    SeqNum recovery_point_;
+};
+
+inline void CongestionControl::reset()
+{
+    cwnd_ = std::min(uint16_t(initial_window_), RELIABLE_STREAM_DEPTH);
+    ssthresh_ = RELIABLE_STREAM_DEPTH;
+    acked_ = 0;
+    in_recovery_ = false;
+    recovery_point_ = SeqNum(0);
+}
+
+inline void CongestionControl::on_ack(uint16_t acked, SeqNum first_unacked)
+{
+    /* The recovery ends when everything sent before the decrease is acknowledged. */
+    if (in_recovery_ && (recovery_point_ < first_unacked))
+    {
+        in_recovery_ = false;
+    }
+
+    for (uint16_t i = 0; i < acked; ++i)
+    {
+        if (cwnd_ < ssthresh_)
+        {
+            ++cwnd_;
+        }
+        else if (++acked_ >= cwnd_)
+        {
+            ++cwnd_;
+            acked_ = 0;
+        }
+    }
+    cwnd_ = std::min(cwnd_, RELIABLE_STREAM_DEPTH);
+}
+
+inline void CongestionControl::on_loss(SeqNum lost, SeqNum last_sent)
+{
+    /* Losses of the window already reacted to do not decrease it again. */
+    if (in_recovery_ && (lost <= recovery_point_))
+    {
+        return;
+    }
+    ssthresh_ = std::max(uint16_t(cwnd_ / 2), uint16_t(1));
+    cwnd_ = ssthresh_;
+    acked_ = 0;
+    in_recovery_ = true;
+    recovery_point_ = last_sent;
+}
+
+inline void CongestionControl::on_timeout(SeqNum last_sent)
+{
+    /* Already collapsed: further timeouts of the same episode keep the threshold. */
+    if (in_recovery_ && (1 == cwnd_))
+    {
+        return;
+    }
+    ssthresh_ = std::max(uint16_t(cwnd_ / 2), uint16_t(1));
+    cwnd_ = 1;
+    acked_ = 0;
+    in_recovery_ = true;
+    recovery_point_ = last_sent;
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_CLIENT_SESSION_CONGESTION_CONTROL_HPP_
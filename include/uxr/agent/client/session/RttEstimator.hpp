@@ -0,0 +1,84 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_CLIENT_SESSION_RTT_ESTIMATOR_HPP_
+#define _UXR_AGENT_CLIENT_SESSION_RTT_ESTIMATOR_HPP_
+
+#include <uxr/agent/config.hpp>
+#include <chrono>
+#include <algorithm>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * @brief The RttEstimator class smooths the round-trip time samples of a session as TCP does
+ *        (RFC 6298): SRTT and RTTVAR are exponentially weighted averages, and the retransmission
+ *        timeout is SRTT + 4 * RTTVAR, bounded by MIN_HEARTBEAT_PERIOD and MAX_HEARTBEAT_PERIOD.
+ *        Until the first sample arrives the timeout is HEARTBEAT_PERIOD.
+ */
+class RttEstimator
+{
+public:
+    RttEstimator() : srtt_(0), rttvar_(0), has_sample_(false) {}
+
+    void add_sample(std::chrono::microseconds rtt);
+    void reset() { *this = RttEstimator(); }
+
+    bool has_sample() const { return has_sample_; }
+    std::chrono::microseconds srtt() const { return srtt_; }
+    std::chrono::microseconds rttvar() const { return rttvar_; }
+    std::chrono::milliseconds rto() const;
+
+private:
+    std::chrono::microseconds srtt_;
+    std::chrono::microseconds rttvar_;
+    bool has_sample_;
+};
+
+inline void RttEstimator::add_sample(std::chrono::microseconds rtt)
+{
+    rtt = std::max(rtt, std::chrono::microseconds(0));
+    if (!has_sample_)
+    {
+        srtt_ = rtt;
+        rttvar_ = rtt / 2;
+        has_sample_ = true;
+    }
+    else
+    {
+        /* RTTVAR first, it uses the previous SRTT. */
+        std::chrono::microseconds delta = (srtt_ > rtt) ? (srtt_ - rtt) : (rtt - srtt_);
+        rttvar_ = (3 * rttvar_ + delta) / 4;
+        srtt_ = (7 * srtt_ + rtt) / 8;
+    }
+}
+
+inline std::chrono::milliseconds RttEstimator::rto() const
+{
+    std::chrono::milliseconds rv(HEARTBEAT_PERIOD);
+    if (has_sample_)
+    {
+        /* Round up to the millisecond, with a 1 ms clock granularity floor for the variance term. */
+        std::chrono::microseconds timeout = srtt_ + std::max(std::chrono::microseconds(1000), 4 * rttvar_);
+        rv = std::chrono::milliseconds((timeout.count() + 999) / 1000);
+    }
+    return std::min(std::max(rv, std::chrono::milliseconds(MIN_HEARTBEAT_PERIOD)),
+                    std::chrono::milliseconds(MAX_HEARTBEAT_PERIOD));
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_CLIENT_SESSION_RTT_ESTIMATOR_HPP_
@@ -17,9 +17,11 @@
 
 #include <uxr/agent/client/session/stream/InputStream.hpp>
 #include <uxr/agent/client/session/stream/OutputStream.hpp>
+#include <uxr/agent/client/session/RttEstimator.hpp>
 #include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 namespace eprosima {
 namespace uxr {
@@ -45,16 +47,51 @@ public:
     std::array<uint8_t, 2> get_nack_bitmap(dds::xrce::StreamId stream_id);
 
     /* Output streams functions. */
-    void push_output_message(dds::xrce::StreamId stream_id, OutputMessagePtr& output_message);
+    bool push_output_message(dds::xrce::StreamId stream_id, OutputMessagePtr& output_message);
+    bool output_window_full(dds::xrce::StreamId stream_id);
     bool get_output_message(dds::xrce::StreamId stream_id, SeqNum seq_num, OutputMessagePtr& output_submessage);
+    bool get_retransmission(dds::xrce::StreamId stream_id,
+                            SeqNum seq_num,
+                            std::chrono::steady_clock::time_point now,
+                            OutputMessagePtr& output_message);
     SeqNum get_first_unacked_seq_nr(dds::xrce::StreamId stream_id);
     SeqNum get_last_unacked_seq_nr(dds::xrce::StreamId stream_id);
-    void update_from_acknack(dds::xrce::StreamId stream_id, SeqNum first_unacked);
+    void update_from_acknack(dds::xrce::StreamId stream_id,
+                             SeqNum first_unacked,
+                             const std::array<uint8_t, 2>& nack_bitmap = {{0, 0}});
     SeqNum next_output_message(dds::xrce::StreamId stream_id);
     std::vector<uint8_t> get_output_streams();
     bool message_pending(dds::xrce::StreamId stream_id);
 
+    /* Congestion control functions. */
+    void set_congestion_control(bool enabled) { congestion_control_ = enabled; }
+    bool congestion_control() const { return congestion_control_; }
+    uint16_t congestion_window(dds::xrce::StreamId stream_id);
+
+    /* Forward error correction functions. */
+    void set_fec_group(uint8_t group_size) { fec_group_ = group_size; }
+    uint8_t fec_group() const { return fec_group_; }
+    bool take_fec_parity(dds::xrce::StreamId stream_id, std::vector<uint8_t>& payload);
+    size_t max_payload_size(dds::xrce::StreamId stream_id) const;
+    void on_fec_parity_skipped() { ++fec_skipped_; }
+    uint64_t fec_parity_skipped() const { return fec_skipped_; }
+
+    /* Round-trip time functions. */
+    void on_heartbeat_sent(dds::xrce::StreamId stream_id, std::chrono::steady_clock::time_point now);
+    void on_acknack_received(dds::xrce::StreamId stream_id, std::chrono::steady_clock::time_point now);
+    std::chrono::milliseconds heartbeat_period(dds::xrce::StreamId stream_id);
+    RttEstimator get_rtt();
+
 private:
+    /* HEARTBEAT probes of a reliable output stream not answered by an ACKNACK yet. */
+    struct HeartbeatProbe
+    {
+        std::chrono::steady_clock::time_point sent;
+        uint8_t unanswered;
+    };
+
+    static constexpr uint8_t max_backoff_ = 6;
+
     std::unordered_map<dds::xrce::StreamId, BestEffortInputStream> besteffort_istreams_;
     std::unordered_map<dds::xrce::StreamId, ReliableInputStream> relible_istreams_;
     std::unordered_map<dds::xrce::StreamId, BestEffortOutputStream> besteffort_ostreams_;
@@ -63,6 +100,12 @@ private:
     std::mutex ri_mtx_;
     std::mutex bo_mtx_;
     std::mutex ro_mtx_;
+    bool congestion_control_{false};
+    uint8_t fec_group_{0};
+    std::atomic<uint64_t> fec_skipped_{0};
+    std::unordered_map<dds::xrce::StreamId, HeartbeatProbe> heartbeat_probes_;
+    RttEstimator rtt_;
+    std::mutex rtt_mtx_;
 };
 
 inline void Session::reset()
@@ -99,6 +142,11 @@ inline void Session::reset()
         it.second.reset();
     }
     ro_lock.unlock();
+
+    /* Outstanding probes are meaningless after a reset, the RTT estimation is kept. */
+    std::unique_lock<std::mutex> rtt_lock(rtt_mtx_);
+    heartbeat_probes_.clear();
+    rtt_lock.unlock();
 }
 
 /**************************************************************************************************
@@ -166,8 +214,9 @@ inline std::array<uint8_t, 2> Session::get_nack_bitmap(const dds::xrce::StreamId
 /**************************************************************************************************
  * Output Stream Methods.
  **************************************************************************************************/
-inline void Session::push_output_message(dds::xrce::StreamId stream_id, OutputMessagePtr& output_message)
+inline bool Session::push_output_message(dds::xrce::StreamId stream_id, OutputMessagePtr& output_message)
 {
+    bool rv = true;
     if (128 > stream_id)
     {
         std::lock_guard<std::mutex> bo_lock(bo_mtx_);
@@ -176,8 +225,23 @@ inline void Session::push_output_message(dds::xrce::StreamId stream_id, OutputMe
     else
     {
         std::lock_guard<std::mutex> ro_lock(ro_mtx_);
-        relible_ostreams_[stream_id].push_message(output_message);
+        ReliableOutputStream& stream = relible_ostreams_[stream_id];
+        stream.set_fec_group(fec_group_);
+        rv = stream.push_message(output_message);
     }
+    return rv;
+}
+
+inline bool Session::output_window_full(dds::xrce::StreamId stream_id)
+{
+    bool rv = false;
+    if (127 < stream_id)
+    {
+        std::lock_guard<std::mutex> ro_lock(ro_mtx_);
+        ReliableOutputStream& stream = relible_ostreams_[stream_id];
+        rv = stream.is_full() || (congestion_control_ && stream.congestion_window_full());
+    }
+    return rv;
 }
 
 inline bool Session::get_output_message(dds::xrce::StreamId stream_id, SeqNum seq_num, OutputMessagePtr& output_message)
@@ -191,6 +255,27 @@ inline bool Session::get_output_message(dds::xrce::StreamId stream_id, SeqNum se
     return rv;
 }
 
+inline bool Session::get_retransmission(dds::xrce::StreamId stream_id,
+                                        SeqNum seq_num,
+                                        std::chrono::steady_clock::time_point now,
+                                        OutputMessagePtr& output_message)
+{
+    bool rv = false;
+    if (127 < stream_id)
+    {
+        /* One smoothed RTT between copies, or the minimum heartbeat period until it is measured. */
+        std::unique_lock<std::mutex> rtt_lock(rtt_mtx_);
+        std::chrono::microseconds holdoff = rtt_.has_sample()
+                ? rtt_.srtt()
+                : std::chrono::microseconds(std::chrono::milliseconds(MIN_HEARTBEAT_PERIOD));
+        rtt_lock.unlock();
+
+        std::lock_guard<std::mutex> ro_lock(ro_mtx_);
+        rv = relible_ostreams_[stream_id].get_retransmission(seq_num, now, holdoff, output_message);
+    }
+    return rv;
+}
+
 inline SeqNum Session::get_first_unacked_seq_nr(const dds::xrce::StreamId stream_id)
 {
     std::lock_guard<std::mutex> ro_lock(ro_mtx_);
@@ -203,12 +288,14 @@ inline SeqNum Session::get_last_unacked_seq_nr(const dds::xrce::StreamId stream_
     return (127 < stream_id) ? relible_ostreams_[stream_id].get_last_available() : SeqNum(0);
 }
 
-inline void Session::update_from_acknack(const dds::xrce::StreamId stream_id, const SeqNum first_unacked)
+inline void Session::update_from_acknack(const dds::xrce::StreamId stream_id,
+                                         const SeqNum first_unacked,
+                                         const std::array<uint8_t, 2>& nack_bitmap)
 {
     if (127 < stream_id)
     {
         std::lock_guard<std::mutex> ro_lock(ro_mtx_);
-        relible_ostreams_[stream_id].update_from_acknack(first_unacked);
+        relible_ostreams_[stream_id].update_from_acknack(first_unacked, nack_bitmap);
     }
 }
 
@@ -251,6 +338,101 @@ inline bool Session::message_pending(const dds::xrce::StreamId stream_id)
     return result;
 }
 
+/**************************************************************************************************
+ * Congestion Control Methods.
+ **************************************************************************************************/
+inline uint16_t Session::congestion_window(dds::xrce::StreamId stream_id)
+{
+    uint16_t rv = RELIABLE_STREAM_DEPTH;
+    if (congestion_control_ && (127 < stream_id))
+    {
+        std::lock_guard<std::mutex> ro_lock(ro_mtx_);
+        rv = relible_ostreams_[stream_id].congestion_window();
+    }
+    return rv;
+}
+
+/**************************************************************************************************
+ * Forward Error Correction Methods.
+ **************************************************************************************************/
+inline bool Session::take_fec_parity(dds::xrce::StreamId stream_id, std::vector<uint8_t>& payload)
+{
+    bool rv = false;
+    if ((0 != fec_group_) && (127 < stream_id))
+    {
+        std::lock_guard<std::mutex> ro_lock(ro_mtx_);
+        rv = relible_ostreams_[stream_id].take_fec_parity(payload);
+    }
+    return rv;
+}
+
+inline size_t Session::max_payload_size(dds::xrce::StreamId stream_id) const
+{
+    /* A FEC_PARITY is as long as the longest message of its group plus its own headers: the messages
+       of a FEC stream leave room for them, so that the parity of a group fits in one message. */
+    size_t rv = OutputMessage::get_max_payload_size();
+    if ((0 != fec_group_) && (127 < stream_id))
+    {
+        rv -= OutputMessage::get_max_header_size() + FEC_PARITY_HEADER_SIZE;
+    }
+    return rv;
+}
+
+/**************************************************************************************************
+ * Round-Trip Time Methods.
+ **************************************************************************************************/
+inline void Session::on_heartbeat_sent(dds::xrce::StreamId stream_id, std::chrono::steady_clock::time_point now)
+{
+    std::unique_lock<std::mutex> rtt_lock(rtt_mtx_);
+    HeartbeatProbe& probe = heartbeat_probes_[stream_id];
+    probe.sent = now;
+    probe.unanswered = uint8_t(std::min(probe.unanswered + 1, 0xFF));
+    bool timeout = (1 < probe.unanswered);
+    rtt_lock.unlock();
+
+    /* The previous HEARTBEAT went unanswered for a whole RTO. */
+    if (timeout && (127 < stream_id))
+    {
+        std::lock_guard<std::mutex> ro_lock(ro_mtx_);
+        relible_ostreams_[stream_id].on_heartbeat_timeout();
+    }
+}
+
+inline void Session::on_acknack_received(dds::xrce::StreamId stream_id, std::chrono::steady_clock::time_point now)
+{
+    std::lock_guard<std::mutex> rtt_lock(rtt_mtx_);
+    auto it = heartbeat_probes_.find(stream_id);
+    if (heartbeat_probes_.end() != it)
+    {
+        /* Karn's rule: an ACKNACK after several HEARTBEATs does not tell which one it answers. */
+        if (1 == it->second.unanswered)
+        {
+            rtt_.add_sample(std::chrono::duration_cast<std::chrono::microseconds>(now - it->second.sent));
+        }
+        heartbeat_probes_.erase(it);
+    }
+}
+
+inline std::chrono::milliseconds Session::heartbeat_period(dds::xrce::StreamId stream_id)
+{
+    std::lock_guard<std::mutex> rtt_lock(rtt_mtx_);
+    std::chrono::milliseconds rv = rtt_.rto();
+
+    /* Exponential backoff from the second unanswered HEARTBEAT on. */
+    auto it = heartbeat_probes_.find(stream_id);
+    if ((heartbeat_probes_.end() != it) && (1 < it->second.unanswered))
+    {
+        rv *= (1 << std::min(uint8_t(it->second.unanswered - 1), uint8_t(max_backoff_)));
+    }
+    return std::min(rv, std::chrono::milliseconds(MAX_HEARTBEAT_PERIOD));
+}
+
+inline RttEstimator Session::get_rtt()
+{
+    std::lock_guard<std::mutex> rtt_lock(rtt_mtx_);
+    return rtt_;
+}
+
 } // namespace uxr
 } // namespace eprosima
 
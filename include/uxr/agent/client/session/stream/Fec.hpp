@@ -0,0 +1,126 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_CLIENT_SESSION_STREAM_FEC_HPP_
+#define _UXR_AGENT_CLIENT_SESSION_STREAM_FEC_HPP_
+
+#include <uxr/agent/utils/SeqNum.hpp>
+#include <vector>
+#include <cstddef>
+
+namespace eprosima {
+namespace uxr {
+
+/*
+ * FEC_PARITY payload, little endian:
+ *  first_seq_nr (2) | count (1) | reserved (1) | length_xor (2) | parity (max length of the group)
+ * The parity is the XOR of the serialized messages of the group, zero padded to the longest one,
+ * and length_xor the XOR of their lengths.
+ */
+const uint8_t FEC_PARITY_SUBMESSAGE_ID = 0x80;
+const size_t FEC_PARITY_HEADER_SIZE = 6;
+
+/**
+ * @brief The FecEncoder class accumulates the XOR parity of groups of K consecutive messages of
+ *        a reliable output stream. A group of size 0 disables it.
+ */
+class FecEncoder
+{
+public:
+    FecEncoder() : group_size_(0) { reset(); }
+
+    void set_group_size(uint8_t group_size);
+    uint8_t group_size() const { return group_size_; }
+
+    /**
+     * @brief Adds a message to the current group, and fills the FEC_PARITY payload when it completes.
+     */
+    bool add_message(SeqNum seq_num, const uint8_t* buf, size_t len, std::vector<uint8_t>& payload);
+    void reset();
+
+private:
+    uint8_t group_size_;
+    uint8_t count_;
+    SeqNum first_;
+    uint16_t length_xor_;
+    std::vector<uint8_t> parity_;
+};
+
+inline void FecEncoder::set_group_size(uint8_t group_size)
+{
+    if (group_size != group_size_)
+    {
+        group_size_ = group_size;
+        reset();
+    }
+}
+
+inline bool FecEncoder::add_message(SeqNum seq_num, const uint8_t* buf, size_t len, std::vector<uint8_t>& payload)
+{
+    bool rv = false;
+    if (0 == group_size_)
+    {
+        return rv;
+    }
+
+    /* A gap in the sequence (stream reset) starts a new group. */
+    if ((0 != count_) && (seq_num != first_ + int(count_)))
+    {
+        reset();
+    }
+    if (0 == count_)
+    {
+        first_ = seq_num;
+    }
+
+    if (parity_.size() < len)
+    {
+        parity_.resize(len, 0);
+    }
+    for (size_t i = 0; i < len; ++i)
+    {
+        parity_[i] ^= buf[i];
+    }
+    length_xor_ ^= uint16_t(len);
+
+    if (group_size_ == ++count_)
+    {
+        uint16_t first = first_;
+        payload.clear();
+        payload.reserve(FEC_PARITY_HEADER_SIZE + parity_.size());
+        payload.push_back(uint8_t(first));
+        payload.push_back(uint8_t(first >> 8));
+        payload.push_back(count_);
+        payload.push_back(0x00);
+        payload.push_back(uint8_t(length_xor_));
+        payload.push_back(uint8_t(length_xor_ >> 8));
+        payload.insert(payload.end(), parity_.begin(), parity_.end());
+        reset();
+        rv = true;
+    }
+    return rv;
+}
+
+inline void FecEncoder::reset()
+{
+    count_ = 0;
+    first_ = SeqNum(0);
+    length_xor_ = 0;
+    parity_.clear();
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_CLIENT_SESSION_STREAM_FEC_HPP_
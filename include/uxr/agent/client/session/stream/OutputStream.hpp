@@ -18,8 +18,12 @@
 #include <uxr/agent/config.hpp>
 #include <uxr/agent/message/Packet.hpp>
 #include <uxr/agent/utils/SeqNum.hpp>
+#include <uxr/agent/client/session/CongestionControl.hpp>
+#include <uxr/agent/client/session/stream/Fec.hpp>
 #include <map>
 #include <queue>
+#include <array>
+#include <chrono>
 
 namespace eprosima {
 namespace uxr {
@@ -81,23 +85,45 @@ public:
 
     bool push_message(OutputMessagePtr& output_message);
     bool get_message(SeqNum seq_num, OutputMessagePtr& output_message);
-    void update_from_acknack(SeqNum first_unacked);
+    bool get_retransmission(SeqNum seq_num,
+                            std::chrono::steady_clock::time_point now,
+                            std::chrono::microseconds holdoff,
+                            OutputMessagePtr& output_message);
+    void update_from_acknack(SeqNum first_unacked, const std::array<uint8_t, 2>& nack_bitmap);
+    void on_heartbeat_timeout() { congestion_control_.on_timeout(last_sent_); }
+    bool congestion_window_full() const { return !(messages_.size() < congestion_control_.window()); }
+    uint16_t congestion_window() const { return congestion_control_.window(); }
+    void set_fec_group(uint8_t group_size) { fec_encoder_.set_group_size(group_size); }
+    bool take_fec_parity(std::vector<uint8_t>& payload);
     SeqNum get_first_available() { return last_acknown_ + 1; }
     SeqNum get_last_available() { return last_sent_; }
     SeqNum next_message() { return last_sent_ + 1; }
     bool message_pending() { return !messages_.empty(); }
+    bool is_full() { return !(last_sent_ < last_acknown_ + SeqNum(RELIABLE_STREAM_DEPTH)); }
     void reset();
 
 private:
+    struct StoredMessage
+    {
+        OutputMessagePtr message;
+        std::chrono::steady_clock::time_point last_sent;
+    };
+
     SeqNum last_sent_;
     SeqNum last_acknown_;
-    std::map<uint16_t, OutputMessagePtr> messages_;
+    std::map<uint16_t, StoredMessage> messages_;
+    CongestionControl congestion_control_;
+    FecEncoder fec_encoder_;
+    std::vector<uint8_t> fec_parity_;
 };
 
 inline ReliableOutputStream::ReliableOutputStream(ReliableOutputStream&& x)
     : last_sent_(x.last_sent_),
       last_acknown_(x.last_acknown_),
-      messages_(std::move(messages_))
+      messages_(std::move(messages_)),
+      congestion_control_(x.congestion_control_),
+      fec_encoder_(std::move(x.fec_encoder_)),
+      fec_parity_(std::move(x.fec_parity_))
 {
 }
 
@@ -106,16 +132,23 @@ inline ReliableOutputStream& ReliableOutputStream::operator=(ReliableOutputStrea
     last_sent_ = x.last_sent_;
     last_acknown_ = x.last_acknown_;
     messages_ = std::move(x.messages_);
+    congestion_control_ = x.congestion_control_;
+    fec_encoder_ = std::move(x.fec_encoder_);
+    fec_parity_ = std::move(x.fec_parity_);
     return *this;
 }
 
 inline bool ReliableOutputStream::push_message(OutputMessagePtr& output_message)
 {
     bool rv = false;
-    if (last_sent_ < last_acknown_ + SeqNum(RELIABLE_STREAM_DEPTH))
+    if (!is_full())
     {
         last_sent_ += 1;
-        messages_.insert(std::make_pair(last_sent_, output_message));
+        messages_.insert(std::make_pair(last_sent_, StoredMessage{output_message, std::chrono::steady_clock::now()}));
+        if (output_message)
+        {
+            fec_encoder_.add_message(last_sent_, output_message->get_buf(), output_message->get_len(), fec_parity_);
+        }
         rv = true;
     }
     return rv;
@@ -127,26 +160,69 @@ inline bool ReliableOutputStream::get_message(SeqNum seq_num, OutputMessagePtr&
     auto it = messages_.find(seq_num);
     if (it != messages_.end())
     {
-        output_message = it->second;
+        output_message = it->second.message;
+        rv = true;
+    }
+    return rv;
+}
+
+/* Repeated NACKs within the holdoff are answered by the copy already on its way. */
+inline bool ReliableOutputStream::get_retransmission(SeqNum seq_num,
+                                                     std::chrono::steady_clock::time_point now,
+                                                     std::chrono::microseconds holdoff,
+                                                     OutputMessagePtr& output_message)
+{
+    bool rv = false;
+    auto it = messages_.find(seq_num);
+    if ((it != messages_.end()) && (it->second.last_sent + holdoff <= now))
+    {
+        it->second.last_sent = now;
+        output_message = it->second.message;
         rv = true;
     }
     return rv;
 }
 
-inline void ReliableOutputStream::update_from_acknack(SeqNum first_unacked)
+inline void ReliableOutputStream::update_from_acknack(SeqNum first_unacked, const std::array<uint8_t, 2>& nack_bitmap)
 {
+    uint16_t acked = 0;
     while ((last_acknown_ + 1 < first_unacked) && (last_acknown_ < last_sent_))
     {
         last_acknown_ += 1;
         messages_.erase(last_acknown_);
+        ++acked;
+    }
+    congestion_control_.on_ack(acked, first_unacked);
+
+    /* Any NACK is a loss signal, reported with the oldest message missing. */
+    for (uint16_t i = 0; i < 16; ++i)
+    {
+        uint8_t mask = uint8_t(0x01 << (i % 8));
+        if ((nack_bitmap.at((i < 8) ? 1 : 0) & mask) == mask)
+        {
+            congestion_control_.on_loss(first_unacked + i, last_sent_);
+            break;
+        }
     }
 }
 
+/* The parity of the last completed group, taken once right after the message that completed it. */
+inline bool ReliableOutputStream::take_fec_parity(std::vector<uint8_t>& payload)
+{
+    bool rv = !fec_parity_.empty();
+    payload.swap(fec_parity_);
+    fec_parity_.clear();
+    return rv;
+}
+
 inline void ReliableOutputStream::reset()
 {
     last_acknown_ = ~0;
     last_sent_ = ~0;
     messages_.clear();
+    congestion_control_.reset();
+    fec_encoder_.reset();
+    fec_parity_.clear();
 }
 
 } // namespace uxr
@@ -0,0 +1,119 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_DATAREADER_CONTENTFILTER_HPP_
+#define _UXR_AGENT_DATAREADER_CONTENTFILTER_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * @brief The ContentFilter class evaluates a READ_DATA content filter expression over the CDR
+ *        representation of a sample (little endian, without encapsulation).
+ *
+ *        The agent does not know the topic types, so the expression starts with the description
+ *        of the leading members of the type, in declaration order:
+ *
+ *            {int32 id; float32 temperature} temperature > 25.5 AND NOT (id = 3 OR id = 4)
+ *
+ *        Supported member types are boolean, octet, char, int8, uint8, int16, uint16, int32,
+ *        uint32, int64, uint64, float32, float64 and string. Comparisons are =, <>, <, <=, >, >=
+ *        between members and numeric or 'string' literals, combined with AND, OR, NOT and parentheses.
+ *        The expression is compiled once; evaluating a sample only decodes the members it refers to.
+ */
+class ContentFilter
+{
+public:
+    ContentFilter() = default;
+
+    bool compile(const std::string& expression);
+    bool empty() const { return program_.empty(); }
+    bool evaluate(const uint8_t* data, size_t size) const;
+
+private:
+    enum class MemberKind : uint8_t
+    {
+        BOOLEAN,
+        INT8,
+        UINT8,
+        INT16,
+        UINT16,
+        INT32,
+        UINT32,
+        INT64,
+        UINT64,
+        FLOAT32,
+        FLOAT64,
+        STRING
+    };
+
+    enum class ValueKind : uint8_t
+    {
+        INTEGER,
+        REAL,
+        STRING
+    };
+
+    struct Value
+    {
+        ValueKind kind;
+        int64_t integer;
+        double real;
+        const char* str;
+        size_t len;
+    };
+
+    enum class OpCode : uint8_t
+    {
+        PUSH_MEMBER,
+        PUSH_LITERAL,
+        EQUAL,
+        NOT_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        AND,
+        OR,
+        NOT
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        size_t index;
+    };
+
+    class Parser;
+
+    bool decode_members(const uint8_t* data, size_t size, std::vector<Value>& values) const;
+    static int compare(const Value& lhs, const Value& rhs);
+
+private:
+    std::vector<MemberKind> members_;
+    std::vector<std::string> literal_strings_;
+    std::vector<Value> literals_;
+    std::vector<Instruction> program_;
+    size_t members_used_{0};
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_DATAREADER_CONTENTFILTER_HPP_
@@ -17,13 +17,16 @@
 
 #include <uxr/agent/object/XRCEObject.hpp>
 #include <uxr/agent/types/TopicPubSubType.hpp>
+#include <uxr/agent/datareader/ContentFilter.hpp>
+#include <uxr/agent/datareader/SharedReader.hpp>
+#include <uxr/agent/scheduler/Executor.hpp>
+#include <uxr/agent/utils/TokenBucket.hpp>
 #include <fastrtps/subscriber/SampleInfo.h>
 #include <fastrtps/subscriber/SubscriberListener.h>
-#include <asio/io_service.hpp>
-#include <asio/steady_timer.hpp>
-#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <thread>
 #include <functional>
 
 namespace eprosima {
@@ -51,34 +54,15 @@ struct ReadCallbackArgs
     dds::xrce::StreamId stream_id;
     dds::xrce::ObjectId object_id;
     dds::xrce::RequestId request_id;
-
+    dds::xrce::DataFormat data_format{dds::xrce::FORMAT_DATA};
+    size_t max_batch_size{0};
+    bool keep_latest{false};
 };
 
-typedef const std::function<void (const ReadCallbackArgs&, std::vector<uint8_t>)> read_callback;
-
-/**
- * @brief The ReadTimeEvent class
+/*
+ * The callback returns false, leaving the samples untouched, when the output stream cannot take them yet.
  */
-class ReadTimeEvent
-{
-  public:
-    ReadTimeEvent();
-    virtual ~ReadTimeEvent()            = default;
-    ReadTimeEvent(ReadTimeEvent&&)      = delete;
-    ReadTimeEvent(const ReadTimeEvent&) = delete;
-    ReadTimeEvent& operator=(ReadTimeEvent&&) = delete;
-    ReadTimeEvent& operator=(const ReadTimeEvent&) = delete;
-
-    int init_max_timer(int milliseconds);
-    void stop_max_timer();
-    void run_max_timer(int milliseconds);
-
-    virtual void on_max_timeout(const asio::error_code& error) = 0;
-
-  protected:
-    asio::io_service m_io_service_max;
-    asio::steady_timer m_timer_max;
-};
+typedef const std::function<bool (const ReadCallbackArgs&, std::vector<dds::xrce::Sample>&)> read_callback;
 
 /**
  * @brief The RTPSSubListener class
@@ -106,12 +90,22 @@ class RTPSSubListener : public fastrtps::SubscriberListener
 
 /**
  * @brief The DataReader class contains the public API that allows the user to control the reception of message.
+ *        Deliveries are driven by the agent Executor: new data, token refills and the max elapsed time
+ *        timer each post a short task, so an active read does not own any thread.
+ *        Reads with a min_pace_period deliver only the most recent sample of each period, and
+ *        keep-latest reads replace the samples waiting for the rate limit with newer ones of the same instance.
+ *        A batch refused by a full reliable output stream is held, and the delivery pauses until
+ *        on_output_window is called; the following samples wait in the RTPS history.
+ *        The rate limit of the reads is drawn from the budget of the client, when given.
+ *        With SHARED_READERS, readers with the same attributes get their samples from a SharedReader
+ *        instead of an RTPS subscriber of their own.
  */
-class DataReader : public XRCEObject, public ReadTimeEvent, public RTPSSubListener
+class DataReader : public XRCEObject, public RTPSSubListener, public std::enable_shared_from_this<DataReader>
 {
 public:
     DataReader(const dds::xrce::ObjectId& object_id,
                const std::shared_ptr<Subscriber>& subscriber,
+               const std::shared_ptr<utils::TokenBucket>& budget = nullptr,
                const std::string& profile_name = "");
     virtual ~DataReader() noexcept override;
 
@@ -121,34 +115,84 @@ public:
     DataReader& operator=(const DataReader&) = delete;
 
     bool init(const dds::xrce::DATAREADER_Representation& representation, const ObjectContainer& root_objects);
-    void read(const dds::xrce::READ_DATA_Payload& read_data, read_callback read_cb, const ReadCallbackArgs& cb_args);
+    bool read(const dds::xrce::READ_DATA_Payload& read_data, read_callback read_cb, const ReadCallbackArgs& cb_args);
     bool has_message() const;
-    void on_max_timeout(const asio::error_code& error) override;
     void onSubscriptionMatched(eprosima::fastrtps::Subscriber* sub,
                                eprosima::fastrtps::rtps::MatchingInfo& info) override;
     void onNewDataMessage(fastrtps::Subscriber*) override;
+    void on_output_window();
     void release(ObjectContainer&) override {}
     bool matched(const dds::xrce::ObjectVariant& new_object_rep) const override;
 
+    /**
+     * @brief Number of samples replaced by a newer sample of the same instance (keep-latest reads).
+     */
+    uint64_t conflated_samples() const { return conflated_count_; }
+
 private:
-    int start_read(const dds::xrce::DataDeliveryControl& delivery_control,
-                   read_callback read_cb, const ReadCallbackArgs& cb_args);
-    int stop_read();
-    void read_task(dds::xrce::DataDeliveryControl delivery_control,
-                   read_callback read_cb, ReadCallbackArgs cb_args);
-    bool takeNextData(void* data);
-    size_t nextDataSize();
+    struct ConflatedSample
+    {
+        fastrtps::rtps::InstanceHandle_t handle;
+        dds::xrce::Sample sample;
+        uint64_t arrival; /* Order of the sample among the conflated ones, the newest being the highest. */
+    };
+
+    void start_read(const dds::xrce::DataDeliveryControl& delivery_control,
+                    read_callback read_cb, const ReadCallbackArgs& cb_args);
+    void stop_read();
+    void post_delivery();
+    void deliver_task();
+    void on_max_timeout(uint32_t read_id);
+    bool takeNextSample(dds::xrce::Sample& sample, fastrtps::rtps::InstanceHandle_t& handle);
+    size_t takeLatestSample(const ContentFilter* content_filter);
+    void conflateSamples(const ContentFilter* content_filter);
+    void conflatePendingBatch();
+    void refilterHeldSamples(const std::shared_ptr<const ContentFilter>& content_filter);
+    void fillSampleInfo(dds::xrce::Sample& sample);
+    size_t nextDataSize(const ContentFilter* content_filter);
+    bool createRTPSSubscriber(fastrtps::Participant* rtps_participant, const fastrtps::SubscriberAttributes& attributes);
+    bool hasSampleSource() const { return (nullptr != rtps_subscriber_) || binding_; }
+    bool takeNextData(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info);
+    bool readNextData(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info);
+    uint64_t getUnreadCount();
 
 private:
     std::shared_ptr<Subscriber> subscriber_;
     std::shared_ptr<Topic> topic_;
-    std::thread read_thread_;
-    std::thread max_timer_thread_;
+    std::weak_ptr<DataReader> self_;
     std::mutex mtx_;
-    std::condition_variable cond_var_;
     bool running_cond_;
+    bool delivering_;
+    bool notified_;
+    uint32_t read_id_;
+    dds::xrce::DataDeliveryControl delivery_control_;
+    std::function<bool (const ReadCallbackArgs&, std::vector<dds::xrce::Sample>&)> read_cb_;
+    ReadCallbackArgs cb_args_;
+    std::shared_ptr<const ContentFilter> content_filter_;
+    utils::TokenBucket rate_manager_;
+    uint16_t message_count_;
+    uint32_t sample_seq_;
+    std::chrono::steady_clock::time_point creation_time_;
+    std::chrono::steady_clock::time_point next_pace_time_;
+    dds::xrce::Sample paced_sample_;
+    bool has_paced_sample_;
+    std::deque<ConflatedSample> conflated_samples_;
+    std::atomic<uint64_t> conflated_count_;
+    uint64_t conflated_arrivals_;
+    std::shared_ptr<const ContentFilter> held_filter_;
+    std::vector<dds::xrce::Sample> pending_batch_;
+    std::vector<fastrtps::rtps::InstanceHandle_t> pending_handles_;
+    ReadCallbackArgs pending_args_;
+    uint32_t pending_read_id_;
+    bool window_full_;
+    Executor::TimerId max_timer_;
+    Executor::TimerId retry_timer_;
     std::string rtps_subscriber_prof_;
+    std::vector<uint8_t> binary_representation_;
+    std::shared_ptr<ContentFilter> default_filter_;
     fastrtps::Subscriber* rtps_subscriber_;
+    std::shared_ptr<SharedReader> shared_reader_;
+    std::shared_ptr<SharedReader::Binding> binding_;
     TopicPubSubType topic_type_;
 };
 
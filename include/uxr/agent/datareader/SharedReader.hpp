@@ -0,0 +1,136 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_DATAREADER_SHARED_READER_HPP_
+#define _UXR_AGENT_DATAREADER_SHARED_READER_HPP_
+
+#include <fastrtps/attributes/SubscriberAttributes.h>
+#include <fastrtps/subscriber/SampleInfo.h>
+#include <fastrtps/subscriber/SubscriberListener.h>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace eprosima {
+
+namespace fastrtps {
+class Participant;
+class Subscriber;
+namespace rtps {
+class MatchingInfo;
+} // namespace rtps
+} // namespace fastrtps
+
+namespace uxr {
+
+/**
+ * @brief The SharedReader class owns the RTPS subscriber of every DataReader created with the same
+ *        attributes on the same RTPS participant. Each sample is taken once from the RTPS history
+ *        and handed to all the bindings as a shared buffer; a DataReader then reads from its
+ *        binding as it would from its own history, with the same depth per instance and limits.
+ *        Durable readers keep the last samples so that late bindings get them too.
+ *        With TOPIC_BUS, samples of the writers of this agent also come through deliver(), for the
+ *        writers its RTPS subscriber matched; whichever copy of a sample comes second is dropped.
+ */
+class SharedReader : public fastrtps::SubscriberListener
+{
+public:
+    struct Sample
+    {
+        std::shared_ptr<const std::vector<unsigned char>> data;
+        fastrtps::SampleInfo_t info;
+    };
+
+    /**
+     * @brief The samples of a DataReader not taken yet. The callbacks run with the SharedReader locked.
+     */
+    class Binding
+    {
+    public:
+        Binding(size_t depth, size_t max_samples,
+                std::function<void ()>&& on_data, std::function<void (int)>&& on_matched)
+            : depth_(depth), max_samples_(max_samples), on_data_(std::move(on_data)), on_matched_(std::move(on_matched))
+        {}
+
+        bool read_next(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info);
+        bool take_next(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info);
+        uint64_t unread_count();
+
+    private:
+        friend class SharedReader;
+        void push(const Sample& sample);
+
+        std::mutex mtx_;
+        std::deque<Sample> samples_;
+        size_t depth_;
+        size_t max_samples_;
+        std::function<void ()> on_data_;
+        std::function<void (int)> on_matched_;
+    };
+
+    ~SharedReader() override;
+
+    SharedReader(SharedReader&&)      = delete;
+    SharedReader(const SharedReader&) = delete;
+    SharedReader& operator=(SharedReader&&) = delete;
+    SharedReader& operator=(const SharedReader&) = delete;
+
+    /**
+     * @brief Returns the shared reader with these attributes, creating its RTPS subscriber if needed.
+     */
+    static std::shared_ptr<SharedReader> acquire(fastrtps::Participant* participant,
+                                                 const fastrtps::SubscriberAttributes& attributes);
+
+    std::shared_ptr<Binding> bind(std::function<void ()>&& on_data, std::function<void (int)>&& on_matched);
+    void unbind(const std::shared_ptr<Binding>& binding);
+    const fastrtps::SubscriberAttributes& get_attributes() const { return attributes_; }
+    size_t bindings();
+
+    /**
+     * @brief Pushes a sample of a local writer, returning false if the RTPS subscriber did not match it.
+     */
+    bool deliver(const Sample& sample);
+
+    void onNewDataMessage(fastrtps::Subscriber* sub) override;
+    void onSubscriptionMatched(fastrtps::Subscriber* sub, fastrtps::rtps::MatchingInfo& info) override;
+
+private:
+    explicit SharedReader(const fastrtps::SubscriberAttributes& attributes);
+    using fastrtps::SubscriberListener::onSubscriptionMatched;
+    void push(const Sample& sample);
+
+    fastrtps::SubscriberAttributes attributes_;
+    fastrtps::Subscriber* rtps_subscriber_;
+    size_t depth_;
+    size_t max_samples_;
+    bool durable_;
+    std::mutex mtx_;
+    std::vector<std::shared_ptr<Binding>> bindings_;
+    std::deque<Sample> history_;
+    int matched_;
+
+    typedef std::map<fastrtps::rtps::GUID_t, std::set<fastrtps::rtps::SequenceNumber_t>> Identities;
+    std::set<fastrtps::rtps::GUID_t> matched_writers_;
+    Identities from_bus_;
+    Identities from_rtps_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_DATAREADER_SHARED_READER_HPP_
@@ -17,9 +17,12 @@
 
 #include <uxr/agent/object/XRCEObject.hpp>
 #include <uxr/agent/types/TopicPubSubType.hpp>
+#include <uxr/agent/datawriter/SharedWriter.hpp>
+#include <uxr/agent/topic/TopicBus.hpp>
 #include <fastrtps/publisher/PublisherListener.h>
 #include <string>
 #include <set>
+#include <mutex>
 
 namespace eprosima {
 
@@ -34,9 +37,21 @@ class Publisher;
 class Topic;
 class WRITE_DATA_Payload;
 
+/**
+ * @brief With SHARED_WRITERS, writers with the same attributes publish through a SharedWriter
+ *        instead of an RTPS publisher of their own; each one still accounts for its own writes.
+ *        With TOPIC_BUS, the samples also go straight to the readers of this agent through the TopicBus.
+ */
 class DataWriter : public XRCEObject, public fastrtps::PublisherListener
 {
 public:
+    struct WriteStats
+    {
+        uint64_t samples;
+        uint64_t bytes;
+        uint64_t errors;
+    };
+
     DataWriter(const dds::xrce::ObjectId& object_id,
                const std::shared_ptr<Publisher>& publisher,
                const std::string& profile_name = "");
@@ -49,19 +64,28 @@ public:
 
     bool init(const dds::xrce::DATAWRITER_Representation& representation, const ObjectContainer& root_objects);
     const dds::xrce::ResultStatus& write(dds::xrce::DataRepresentation& data);
-    bool write(dds::xrce::WRITE_DATA_Payload_Data& write_data);
+    bool write(const uint8_t* data, size_t size);
     void release(ObjectContainer&) override {}
     bool matched(const dds::xrce::ObjectVariant& new_object_rep) const override;
+    fastrtps::Publisher* get_rtps_publisher() const;
+    WriteStats get_write_stats() const;
 
 private:
     void onPublicationMatched(fastrtps::Publisher* pub, fastrtps::rtps::MatchingInfo& info) override;
+    bool createRTPSPublisher(fastrtps::Participant* rtps_participant, const fastrtps::PublisherAttributes& attributes);
     std::shared_ptr<Publisher> publisher_;
     std::shared_ptr<Topic> topic_;
     fastrtps::Publisher* rtps_publisher_;
+    std::shared_ptr<SharedWriter> shared_writer_;
+    TopicBus::Key bus_key_;
+    bool on_bus_;
     std::string rtps_publisher_prof_;
+    std::vector<uint8_t> binary_representation_;
     TopicPubSubType topic_type_;
     dds::xrce::ResultStatus result_status_;
     std::set<dds::xrce::ObjectId> objects_;
+    mutable std::mutex stats_mtx_;
+    WriteStats write_stats_;
 };
 
 } // namespace uxr
@@ -0,0 +1,74 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_DATAWRITER_SHARED_WRITER_HPP_
+#define _UXR_AGENT_DATAWRITER_SHARED_WRITER_HPP_
+
+#include <fastrtps/attributes/PublisherAttributes.h>
+#include <fastrtps/publisher/PublisherListener.h>
+#include <fastrtps/rtps/common/WriteParams.h>
+#include <memory>
+#include <mutex>
+
+namespace eprosima {
+
+namespace fastrtps {
+class Participant;
+class Publisher;
+namespace rtps {
+class MatchingInfo;
+} // namespace rtps
+} // namespace fastrtps
+
+namespace uxr {
+
+/**
+ * @brief The SharedWriter class owns the RTPS publisher of every DataWriter created with the same
+ *        attributes on the same RTPS participant, so that a single history and a single set of
+ *        matching and discovery state serve all of them. It lives as long as one of them holds it.
+ */
+class SharedWriter : public fastrtps::PublisherListener
+{
+public:
+    ~SharedWriter() override;
+
+    SharedWriter(SharedWriter&&)      = delete;
+    SharedWriter(const SharedWriter&) = delete;
+    SharedWriter& operator=(SharedWriter&&) = delete;
+    SharedWriter& operator=(const SharedWriter&) = delete;
+
+    /**
+     * @brief Returns the shared writer with these attributes, creating its RTPS publisher if needed.
+     */
+    static std::shared_ptr<SharedWriter> acquire(fastrtps::Participant* participant,
+                                                 const fastrtps::PublisherAttributes& attributes);
+
+    bool write(const uint8_t* data, size_t size, fastrtps::rtps::WriteParams& params);
+    const fastrtps::PublisherAttributes& get_attributes() const { return attributes_; }
+    fastrtps::Publisher* get_rtps_publisher() const { return rtps_publisher_; }
+
+    void onPublicationMatched(fastrtps::Publisher* pub, fastrtps::rtps::MatchingInfo& info) override;
+
+private:
+    explicit SharedWriter(const fastrtps::PublisherAttributes& attributes);
+
+    fastrtps::PublisherAttributes attributes_;
+    fastrtps::Publisher* rtps_publisher_;
+    std::mutex mtx_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_DATAWRITER_SHARED_WRITER_HPP_
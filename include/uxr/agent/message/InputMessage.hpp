@@ -52,6 +52,8 @@ public:
     const dds::xrce::MessageHeader& get_header() const { return header_; }
     const dds::xrce::SubmessageHeader& get_subheader() const { return subheader_; }
     template<class T> bool get_payload(T& data);
+    bool get_serialized_data(const uint8_t*& data, size_t& size);
+    bool get_sequence_length(uint32_t& length);
     bool prepare_next_submessage();
 
 private:
@@ -92,6 +94,7 @@ template<class T> inline bool InputMessage::get_payload(T& data)
     return rv;
 }
 
+template bool InputMessage::get_payload(dds::xrce::BaseObjectRequest& data);
 template bool InputMessage::get_payload(dds::xrce::CREATE_CLIENT_Payload& data);
 template bool InputMessage::get_payload(dds::xrce::CREATE_Payload& data);
 template bool InputMessage::get_payload(dds::xrce::DELETE_Payload& data);
@@ -99,6 +102,54 @@ template bool InputMessage::get_payload(dds::xrce::READ_DATA_Payload& data);
 template bool InputMessage::get_payload(dds::xrce::WRITE_DATA_Payload_Data& data);
 template bool InputMessage::get_payload(dds::xrce::HEARTBEAT_Payload& data);
 template bool InputMessage::get_payload(dds::xrce::ACKNACK_Payload& data);
+template bool InputMessage::get_payload(dds::xrce::SampleInfo& data);
+template bool InputMessage::get_payload(dds::xrce::SampleInfoDelta& data);
+
+/*
+ * Gets a reference to the next serialized sample (an octet sequence) inside the message buffer,
+ * avoiding the intermediate copy performed by SampleData deserialization.
+ */
+inline bool InputMessage::get_serialized_data(const uint8_t*& data, size_t& size)
+{
+    bool rv = false;
+    uint32_t length;
+    try
+    {
+        deserializer_ >> length;
+        size_t remaining = fastbuffer_.getBufferSize() - deserializer_.getSerializedDataLength();
+        if (length <= remaining)
+        {
+            data = reinterpret_cast<const uint8_t*>(deserializer_.getCurrentPosition());
+            size = length;
+            rv = deserializer_.jump(length);
+        }
+    }
+    catch(eprosima::fastcdr::exception::NotEnoughMemoryException & /*exception*/)
+    {
+        std::cout << "deserialize eprosima::fastcdr::exception::NotEnoughMemoryException" << std::endl;
+    }
+    return rv;
+}
+
+/*
+ * Gets the length of the next sequence, so its elements can be read one by one in place.
+ * Every element takes at least 4 bytes, which bounds the length by the remaining buffer.
+ */
+inline bool InputMessage::get_sequence_length(uint32_t& length)
+{
+    bool rv = false;
+    try
+    {
+        deserializer_ >> length;
+        size_t remaining = fastbuffer_.getBufferSize() - deserializer_.getSerializedDataLength();
+        rv = (length <= (remaining / 4));
+    }
+    catch(eprosima::fastcdr::exception::NotEnoughMemoryException & /*exception*/)
+    {
+        std::cout << "deserialize eprosima::fastcdr::exception::NotEnoughMemoryException" << std::endl;
+    }
+    return rv;
+}
 
 template<class T> inline bool InputMessage::deserialize(T& data)
 {
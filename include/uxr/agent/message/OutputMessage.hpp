@@ -22,6 +22,8 @@
 #include <fastcdr/Cdr.h>
 #include <fastcdr/exceptions/Exception.h>
 #include <iostream>
+#include <atomic>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
@@ -32,15 +34,24 @@ public:
     OutputMessage(const dds::xrce::MessageHeader& header)
         : buf_{},
           fastbuffer_(reinterpret_cast<char*>(buf_.data()), buf_.size()),
-          serializer_(fastbuffer_)
+          serializer_(fastbuffer_),
+          queued_(false)
     {
         serialize(header);
     }
 
     uint8_t* get_buf() { return buf_.data(); }
     size_t get_len() { return serializer_.getSerializedDataLength(); }
+    static size_t get_max_payload_size() { return mtu_size - max_header_size; }
+    static size_t get_max_header_size() { return max_header_size; }
+    static size_t get_mtu_size() { return mtu_size; }
     template<class T>
     bool append_submessage(dds::xrce::SubmessageId submessage_id, const T& data, uint8_t flags = 0x01);
+    bool append_raw_submessage(uint8_t submessage_id, const std::vector<uint8_t>& data, uint8_t flags = 0x01);
+
+    /* A message waits at most once in the output scheduler; mark_queued fails for a second copy. */
+    bool mark_queued() { return !queued_.exchange(true); }
+    void mark_sent() { queued_ = false; }
 
 private:
     bool append_subheader(dds::xrce::SubmessageId submessage_id, uint8_t flags, size_t submessage_len);
@@ -48,9 +59,11 @@ private:
 
 private:
     static const size_t mtu_size = max_mtu(max_mtu(TCP_TRANSPORT_MTU, UDP_TRANSPORT_MTU), SERIAL_TRANSPORT_MTU);
+    static const size_t max_header_size = 8 /* MessageHeader with ClientKey */ + 4 /* SubmessageHeader */;
     std::array<uint8_t, mtu_size> buf_;
     fastcdr::FastBuffer fastbuffer_;
     fastcdr::Cdr serializer_;
+    std::atomic<bool> queued_;
 };
 
 template<class T>
@@ -64,6 +77,25 @@ inline bool OutputMessage::append_submessage(dds::xrce::SubmessageId submessage_
     return rv;
 }
 
+/* For payloads already laid out by the caller, such as protocol extensions without an IDL type. */
+inline bool OutputMessage::append_raw_submessage(uint8_t submessage_id, const std::vector<uint8_t>& data, uint8_t flags)
+{
+    bool rv = false;
+    if (append_subheader(static_cast<dds::xrce::SubmessageId>(submessage_id), flags, data.size()))
+    {
+        try
+        {
+            serializer_.serializeArray(data.data(), data.size());
+            rv = true;
+        }
+        catch(eprosima::fastcdr::exception::NotEnoughMemoryException & /*exception*/)
+        {
+            std::cout << "serialize eprosima::fastcdr::exception::NotEnoughMemoryException" << std::endl;
+        }
+    }
+    return rv;
+}
+
 inline bool OutputMessage::append_subheader(dds::xrce::SubmessageId submessage_id, uint8_t flags, size_t submessage_len)
 {
     dds::xrce::SubmessageHeader subheader;
@@ -17,6 +17,8 @@
 
 #include <uxr/agent/message/InputMessage.hpp>
 #include <uxr/agent/message/OutputMessage.hpp>
+#include <uxr/agent/utils/TokenBucket.hpp>
+#include <uxr/agent/utils/Pacer.hpp>
 #include <memory>
 
 namespace eprosima {
@@ -37,6 +39,9 @@ struct OutputPacket
 {
     std::shared_ptr<EndPoint> destination;
     OutputMessagePtr message;
+    std::shared_ptr<utils::TokenBucket> budget;
+    std::shared_ptr<utils::Pacer> pacer;
+    bool prepaid = false; /* The payload was already drawn from the budget. */
 };
 
 } // namespace uxr
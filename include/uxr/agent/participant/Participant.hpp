@@ -16,6 +16,7 @@
 #define _UXR_AGENT_PARTICIPANT_HPP_
 
 #include <uxr/agent/object/XRCEObject.hpp>
+#include <fastrtps/attributes/ParticipantAttributes.h>
 #include <unordered_map>
 #include <string>
 #include <set>
@@ -26,13 +27,14 @@ class Participant;
 }
 }
 
-#include <fastrtps/participant/ParticipantDiscoveryInfo.h>
-#include <fastrtps/participant/ParticipantListener.h>
-
 namespace eprosima {
 namespace uxr {
 
-class Participant : public XRCEObject, public fastrtps::ParticipantListener
+/*
+ * The RTPS participant comes from the ParticipantPool and may be shared with other clients,
+ * so matching is checked against the attributes this participant asked for.
+ */
+class Participant : public XRCEObject
 {
 public:
     Participant(const dds::xrce::ObjectId& id);
@@ -49,8 +51,8 @@ public:
     bool matched(const dds::xrce::ObjectVariant& new_object_rep) const override;
 
 private:
-    void onParticipantDiscovery(fastrtps::Participant* p, fastrtps::ParticipantDiscoveryInfo info) override;
     fastrtps::Participant* rtps_participant_ = nullptr;
+    fastrtps::ParticipantAttributes attributes_;
     std::unordered_map<std::string, dds::xrce::ObjectId> registered_topics_;
     std::set<dds::xrce::ObjectId> tied_objects_;
 };
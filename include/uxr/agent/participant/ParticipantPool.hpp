@@ -0,0 +1,122 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_PARTICIPANT_PARTICIPANT_POOL_HPP_
+#define _UXR_AGENT_PARTICIPANT_PARTICIPANT_POOL_HPP_
+
+#include <uxr/agent/types/TopicPubSubType.hpp>
+#include <fastrtps/attributes/ParticipantAttributes.h>
+#include <fastrtps/participant/ParticipantDiscoveryInfo.h>
+#include <fastrtps/participant/ParticipantListener.h>
+#include <unordered_map>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace eprosima {
+namespace fastrtps {
+class Participant;
+}
+}
+
+namespace eprosima {
+namespace uxr {
+
+class Executor;
+
+/**
+ * @brief The ParticipantPool class maps the XRCE participants of every client onto shared RTPS
+ *        participants. Participants are keyed by domain and by their attributes, normalized so that
+ *        the participant name does not split them, and removed when the last reference goes.
+ *        Types are reference counted too, since a type name can only be registered once per
+ *        RTPS participant.
+ *        RTPS participants are created and removed without holding the pool lock.
+ *        Warm participants are created ahead of any client for the configurations given to
+ *        prewarm(): acquire() claims one of them instead of creating a participant, and a background
+ *        worker tops the pool up again.
+ */
+class ParticipantPool : public fastrtps::ParticipantListener
+{
+public:
+    ParticipantPool();
+    ~ParticipantPool();
+
+    ParticipantPool(ParticipantPool&&)      = delete;
+    ParticipantPool(const ParticipantPool&) = delete;
+    ParticipantPool& operator=(ParticipantPool&&) = delete;
+    ParticipantPool& operator=(const ParticipantPool&) = delete;
+
+    static ParticipantPool& instance();
+
+    fastrtps::Participant* acquire(const fastrtps::ParticipantAttributes& attributes);
+    void release(fastrtps::Participant* participant);
+    bool register_type(fastrtps::Participant* participant, const std::string& type_name, bool with_key);
+    void unregister_type(fastrtps::Participant* participant, const std::string& type_name);
+    size_t size();
+    size_t references(fastrtps::Participant* participant);
+
+    /**
+     * @brief Keeps count idle participants of the given profile, or of the default profile on
+     *        the given domain. They are created before returning.
+     */
+    bool prewarm(const std::string& profile, size_t count);
+    bool prewarm(uint16_t domain_id, size_t count);
+    size_t warm_size();
+
+    /**
+     * @brief Stops the top up and removes the idle participants.
+     */
+    void clear_warm();
+
+private:
+    bool prewarm(const fastrtps::ParticipantAttributes& attributes, size_t count);
+    fastrtps::Participant* share(const fastrtps::ParticipantAttributes& normalized);
+    void top_up(size_t warm_index);
+    void onParticipantDiscovery(fastrtps::Participant* p, fastrtps::ParticipantDiscoveryInfo info) override;
+
+    struct RegisteredType
+    {
+        std::unique_ptr<TopicPubSubType> type;
+        size_t references;
+    };
+
+    struct Entry
+    {
+        fastrtps::ParticipantAttributes attributes;
+        size_t references;
+        std::map<std::string, RegisteredType> types;
+    };
+
+    struct Warm
+    {
+        fastrtps::ParticipantAttributes attributes;
+        fastrtps::ParticipantAttributes normalized;
+        size_t count;
+        size_t pending;
+        std::vector<fastrtps::Participant*> idle;
+    };
+
+    std::unordered_map<fastrtps::Participant*, Entry> participants_;
+    std::multimap<uint32_t, fastrtps::Participant*> domains_;
+    std::vector<Warm> warm_;
+    std::unique_ptr<Executor> warmer_;
+    std::mutex mtx_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_PARTICIPANT_PARTICIPANT_POOL_HPP_
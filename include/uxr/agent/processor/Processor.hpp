@@ -15,14 +15,19 @@
 #ifndef _UXR_AGENT_PROCESSOR_PROCESSOR_HPP_
 #define _UXR_AGENT_PROCESSOR_PROCESSOR_HPP_
 
+#include <uxr/agent/message/Packet.hpp>
 #include <cstdint>
 #include <vector>
+#include <memory>
 #include <mutex>
+#include <deque>
+#include <map>
 
 namespace dds {
 namespace xrce {
 
 class TransportAddress;
+class Sample;
 
 }
 }
@@ -33,10 +38,14 @@ namespace uxr {
 class Root;
 class Server;
 class ProxyClient;
-struct InputPacket;
-struct OutputPacket;
+class Executor;
 struct ReadCallbackArgs;
 
+/*
+ * With CREATION_THREADS, CREATE runs on a dedicated pool and its STATUS is sent when it completes.
+ * Meanwhile the messages of the client on its user streams wait in order behind the creation,
+ * whereas the other clients and the session traffic on stream 0x00 go on.
+ */
 class Processor
 {
 public:
@@ -47,12 +56,16 @@ public:
     bool process_get_info_packet(InputPacket&& input_packet,
                                  dds::xrce::TransportAddress& address,
                                  OutputPacket& output_packet) const;
-    void check_heartbeats();
     Root* get_root() { return root_; }
     Server* get_server() { return server_; }
 
 private:
     void process_input_message(ProxyClient& client, InputPacket& input_packet);
+    void dispatch_input_message(ProxyClient& client, InputPacket& input_packet);
+    void complete_create(const std::shared_ptr<ProxyClient>& client,
+                         const std::shared_ptr<EndPoint>& source,
+                         const dds::xrce::CreationMode& creation_mode,
+                         const dds::xrce::CREATE_Payload& create_payload);
     bool process_submessage(ProxyClient& client, InputPacket& input_packet);
     bool process_create_client_submessage(InputPacket& input_packet);
     bool process_create_submessage(ProxyClient& client, InputPacket& input_packet);
@@ -63,12 +76,29 @@ private:
     bool process_heartbeat_submessage(ProxyClient& client, InputPacket& input_packet);
     bool process_reset_submessage(ProxyClient& client, InputPacket&);
 
-    void read_data_callback(const ReadCallbackArgs& cb_args, const std::vector<uint8_t>& buffer);
+    bool read_data_callback(const ReadCallbackArgs& cb_args, std::vector<dds::xrce::Sample>& samples);
+    template<class T>
+    void push_data_submessage(ProxyClient& client, const ReadCallbackArgs& cb_args, const T& payload, uint8_t format_flag);
+
+    void arm_heartbeat(ProxyClient& client, uint8_t stream_id);
+    void on_heartbeat_timer(const std::weak_ptr<ProxyClient>& weak_client, uint8_t stream_id);
+    void send_heartbeat(ProxyClient& client, uint8_t stream_id);
+    void send_fec_parity(ProxyClient& client, uint8_t stream_id);
 
 private:
+    struct PendingCreation
+    {
+        uint64_t owner;
+        std::deque<InputPacket> deferred;
+    };
+
     Server* server_;
     Root* root_;
     std::mutex mtx_;
+    std::unique_ptr<Executor> creation_executor_;
+    std::mutex pending_mtx_;
+    std::map<dds::xrce::ClientKey, PendingCreation> pending_;
+    uint64_t last_creation_;
 };
 
 } // namespace uxr
@@ -0,0 +1,83 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_SCHEDULER_EXECUTOR_HPP_
+#define _UXR_AGENT_SCHEDULER_EXECUTOR_HPP_
+
+#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/TimerWheel.hpp>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * @brief The Executor class runs short, non-blocking tasks on a fixed pool of worker threads.
+ *        Delayed tasks are kept in a millisecond TimerWheel by a single timer thread, which hands
+ *        them to the workers once their deadline is reached, so neither the number of threads nor
+ *        the timer cost depend on the number of objects that may arm a timer.
+ */
+class Executor
+{
+public:
+    typedef TimerWheel::Task Task;
+    typedef TimerWheel::TimerId TimerId;
+
+    explicit Executor(size_t thread_count);
+    ~Executor();
+
+    Executor(Executor&&)      = delete;
+    Executor(const Executor&) = delete;
+    Executor& operator=(Executor&&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief Agent-wide executor, sized with EXECUTOR_THREADS.
+     */
+    static Executor& instance();
+
+    void post(Task&& task);
+    TimerId schedule(std::chrono::milliseconds delay, Task&& task);
+    bool cancel(TimerId timer_id);
+    size_t thread_count() const { return workers_.size(); }
+
+private:
+    void worker_loop();
+    void timer_loop();
+    TimerWheel::Tick to_tick(std::chrono::steady_clock::time_point time_point) const;
+
+private:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    FCFSScheduler<Task> tasks_;
+    std::vector<std::thread> workers_;
+    std::thread timer_thread_;
+    std::mutex timer_mtx_;
+    std::condition_variable timer_cond_;
+    TimePoint start_;
+    TimerWheel wheel_;
+    TimerWheel::Tick wake_tick_;
+    TimerId last_timer_id_;
+    bool running_cond_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_SCHEDULER_EXECUTOR_HPP_
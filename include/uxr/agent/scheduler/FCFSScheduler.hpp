@@ -51,8 +51,9 @@ inline void FCFSScheduler<T>::init()
 template<class T>
 inline void FCFSScheduler<T>::deinit()
 {
+    std::lock_guard<std::mutex> lock(mtx_);
     running_cond_ = false;
-    cond_var_.notify_one();
+    cond_var_.notify_all();
 }
 
 template<class T>
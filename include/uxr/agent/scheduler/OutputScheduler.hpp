@@ -0,0 +1,72 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_SCHEDULER_OUTPUT_SCHEDULER_HPP_
+#define _UXR_AGENT_SCHEDULER_OUTPUT_SCHEDULER_HPP_
+
+#include <uxr/agent/scheduler/Scheduler.hpp>
+#include <uxr/agent/message/Packet.hpp>
+#include <array>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * @brief The OutputScheduler class keeps a backlog per flow (client budget and destination pacer)
+ *        and hands out the packets whose budget grants their size and whose pacer releases them.
+ *        Within a flow, lower priority packets wait behind higher priority ones; flows are served
+ *        round-robin so a throttled or paced client does not block the others.
+ *        A flow holding more than OUTPUT_QUEUE_SIZE packets drops its oldest best-effort ones.
+ */
+class OutputScheduler : public Scheduler<OutputPacket>
+{
+public:
+    enum Priority : uint8_t
+    {
+        CONTROL_PRIORITY = 0,
+        RELIABLE_PRIORITY = 1,
+        BEST_EFFORT_PRIORITY = 2
+    };
+
+    OutputScheduler();
+
+    void init() override;
+    void deinit() override;
+    void push(OutputPacket&& element, uint8_t priority) override;
+    bool pop(OutputPacket& element) override;
+
+    static uint8_t get_priority(uint8_t stream_id);
+
+private:
+    typedef std::array<std::deque<OutputPacket>, BEST_EFFORT_PRIORITY + 1> Backlog;
+    typedef std::pair<std::shared_ptr<utils::TokenBucket>, std::shared_ptr<utils::Pacer>> Flow;
+
+    bool pop_backlog(Backlog& backlog, const Flow& flow, OutputPacket& element, std::chrono::microseconds& wait);
+
+private:
+    std::map<Flow, Backlog> backlogs_;
+    Flow last_served_;
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+    bool running_cond_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_SCHEDULER_OUTPUT_SCHEDULER_HPP_
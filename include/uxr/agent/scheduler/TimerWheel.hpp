@@ -0,0 +1,99 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_SCHEDULER_TIMER_WHEEL_HPP_
+#define _UXR_AGENT_SCHEDULER_TIMER_WHEEL_HPP_
+
+#include <functional>
+#include <array>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * @brief The TimerWheel class keeps timers in a hierarchical timing wheel measured in ticks.
+ *        Scheduling and cancelling are constant time, and advancing only visits the slots that
+ *        are due, so the cost depends on the active timers and not on how many objects own one.
+ *        Timers beyond the last level are parked in it and cascaded down again.
+ *        The class is not thread-safe.
+ */
+class TimerWheel
+{
+public:
+    typedef uint64_t TimerId;
+    typedef uint64_t Tick;
+    typedef std::function<void ()> Task;
+
+    static constexpr Tick never = UINT64_MAX;
+
+    explicit TimerWheel(Tick now = 0);
+
+    void schedule(TimerId timer_id, Tick expiry, Task&& task);
+    bool cancel(TimerId timer_id);
+
+    /**
+     * @brief Moves the wheel up to now and appends the expired tasks in expiry order.
+     */
+    void advance(Tick now, std::vector<Task>& expired);
+
+    /**
+     * @brief Returns the tick at which advance has some work to do (fire or cascade), or never.
+     */
+    Tick next_expiry() const;
+
+    Tick current() const { return current_; }
+    size_t size() const { return locations_.size(); }
+    bool empty() const { return locations_.empty(); }
+
+private:
+    struct Timer
+    {
+        TimerId id;
+        Tick expiry;
+        Task task;
+    };
+
+    typedef std::list<Timer> Slot;
+
+    struct Location
+    {
+        uint8_t level;
+        uint8_t slot;
+        Slot::iterator it;
+    };
+
+    static constexpr uint8_t slot_bits_ = 6;
+    static constexpr uint8_t slot_count_ = 1 << slot_bits_;
+    static constexpr uint8_t level_count_ = 4;
+
+    void insert(Timer&& timer);
+    void cascade(uint8_t level);
+    static uint8_t slot_index(Tick tick, uint8_t level) { return (tick >> (slot_bits_ * level)) & (slot_count_ - 1); }
+
+private:
+    Tick current_;
+    std::array<std::array<Slot, slot_count_>, level_count_> levels_;
+    std::array<size_t, level_count_> level_sizes_;
+    std::unordered_map<TimerId, Location> locations_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_SCHEDULER_TIMER_WHEEL_HPP_
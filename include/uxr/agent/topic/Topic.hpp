@@ -16,7 +16,6 @@
 #define _UXR_AGENT_TOPIC_TOPIC_HPP_
 
 #include <uxr/agent/object/XRCEObject.hpp>
-#include <uxr/agent/types/TopicPubSubType.hpp>
 #include <string>
 #include <memory>
 #include <set>
@@ -37,16 +36,23 @@ class Topic : public XRCEObject
     ~Topic() override;
 
     bool init(const dds::xrce::OBJK_TOPIC_Representation& representation);
+    static std::shared_ptr<Topic> find(const ObjectContainer& root_objects,
+                                       const std::shared_ptr<Participant>& participant,
+                                       const std::string& name);
     virtual void release(ObjectContainer&) override;
     void tie_object(const dds::xrce::ObjectId& object_id) { tied_objects_.insert(object_id); }
     void untie_object(const dds::xrce::ObjectId& object_id) { tied_objects_.erase(object_id); }
     bool matched(const dds::xrce::ObjectVariant& new_object_rep) const override;
+    const std::string& get_name() const { return name; }
+    const std::string& get_type_name() const { return type_name; }
+    bool with_key() const { return with_key_; }
+    const std::shared_ptr<Participant>& get_participant() const { return participant_; }
 
   private:
     std::string name;
     std::string type_name;
     std::shared_ptr<Participant> participant_;
-    TopicPubSubType generic_type_;
+    bool with_key_;
     std::set<dds::xrce::ObjectId> tied_objects_;
 };
 
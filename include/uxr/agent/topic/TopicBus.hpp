@@ -0,0 +1,87 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_TOPIC_TOPIC_BUS_HPP_
+#define _UXR_AGENT_TOPIC_TOPIC_BUS_HPP_
+
+#include <fastrtps/rtps/common/Types.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace eprosima {
+namespace uxr {
+
+class SharedReader;
+
+/**
+ * @brief The TopicBus class hands the samples written by the clients of this agent straight to the
+ *        SharedReaders of the same domain, topic and type, without a round trip through the RTPS stack.
+ *        A SharedReader only takes the samples of the writers its RTPS subscriber matched, so
+ *        partitions and QoS apply as they do through RTPS. Samples still go to RTPS for the readers
+ *        outside the agent; the local ones drop the copy of each sample that comes second.
+ */
+class TopicBus
+{
+public:
+    struct Key
+    {
+        uint32_t domain_id;
+        std::string topic_name;
+        std::string type_name;
+
+        bool operator<(const Key& other) const
+        {
+            return (domain_id != other.domain_id) ? (domain_id < other.domain_id)
+                 : (topic_name != other.topic_name) ? (topic_name < other.topic_name)
+                 : (type_name < other.type_name);
+        }
+    };
+
+    TopicBus() = default;
+    ~TopicBus() = default;
+
+    TopicBus(TopicBus&&)      = delete;
+    TopicBus(const TopicBus&) = delete;
+    TopicBus& operator=(TopicBus&&) = delete;
+    TopicBus& operator=(const TopicBus&) = delete;
+
+    static TopicBus& instance();
+
+    void subscribe(const Key& key, const std::weak_ptr<SharedReader>& shared_reader);
+    void add_writer(const fastrtps::rtps::GUID_t& writer_guid);
+    void remove_writer(const fastrtps::rtps::GUID_t& writer_guid);
+    bool is_local_writer(const fastrtps::rtps::GUID_t& writer_guid);
+
+    /**
+     * @brief Delivers a sample to the local readers of the key matched with its writer, returning how many got it.
+     */
+    size_t publish(const Key& key,
+                   const fastrtps::rtps::SampleIdentity& sample_identity,
+                   const uint8_t* data,
+                   size_t size);
+
+private:
+    std::multimap<Key, std::weak_ptr<SharedReader>> readers_;
+    std::mutex readers_mtx_;
+    std::multiset<fastrtps::rtps::GUID_t> writers_;
+    std::mutex writers_mtx_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_TOPIC_TOPIC_BUS_HPP_
@@ -17,6 +17,7 @@
 
 #include <uxr/agent/transport/EndPoint.hpp>
 #include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/OutputScheduler.hpp>
 #include <uxr/agent/message/Packet.hpp>
 #include <uxr/agent/processor/Processor.hpp>
 #include <uxr/agent/agent_dll.hpp>
@@ -41,6 +42,7 @@ public:
     virtual void on_delete_client(EndPoint* source) = 0;
     virtual const dds::xrce::ClientKey get_client_key(EndPoint* source) = 0;
     virtual std::unique_ptr<EndPoint> get_source(const dds::xrce::ClientKey& client_key) = 0;
+    virtual std::shared_ptr<utils::Pacer> get_pacer(const OutputPacket& /*output_packet*/) { return nullptr; }
 
 private:
     virtual bool init() = 0;
@@ -51,7 +53,6 @@ private:
     void receiver_loop();
     void sender_loop();
     void processing_loop();
-    void heartbeat_loop();
 
 protected:
     Processor* processor_;
@@ -60,10 +61,9 @@ private:
     std::unique_ptr<std::thread> receiver_thread_;
     std::unique_ptr<std::thread> sender_thread_;
     std::unique_ptr<std::thread> processing_thread_;
-    std::unique_ptr<std::thread> heartbeat_thread_;
     std::atomic<bool> running_cond_;
     FCFSScheduler<InputPacket> input_scheduler_;
-    FCFSScheduler<OutputPacket> output_scheduler_;
+    OutputScheduler output_scheduler_;
 };
 
 } // namespace uxr
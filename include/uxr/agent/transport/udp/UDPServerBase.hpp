@@ -33,6 +33,7 @@ public:
     virtual void on_delete_client(EndPoint* source) override;
     virtual const dds::xrce::ClientKey get_client_key(EndPoint* source) override;
     virtual std::unique_ptr<EndPoint> get_source(const dds::xrce::ClientKey& client_key) override;
+    virtual std::shared_ptr<utils::Pacer> get_pacer(const OutputPacket& output_packet) override;
 
 protected:
     uint16_t port_;
@@ -40,6 +41,7 @@ protected:
 private:
     std::unordered_map<uint64_t, uint32_t> source_to_client_map_;
     std::unordered_map<uint32_t, uint64_t> client_to_source_map_;
+    std::unordered_map<uint64_t, std::shared_ptr<utils::Pacer>> pacers_;
     std::mutex clients_mtx_;
 };
 
@@ -23,6 +23,16 @@ using namespace eprosima::fastrtps;
 namespace eprosima {
 namespace uxr {
 
+/*
+ * Non-owning reference to a serialized sample. It is the type handed to the RTPS publisher on write,
+ * so the sample is copied once, from the XRCE message buffer to the RTPS history.
+ */
+struct SerializedDataView
+{
+    const uint8_t* data;
+    size_t size;
+};
+
 class TopicPubSubType: public TopicDataType
 {
 public:
@@ -0,0 +1,78 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_UTILS_PACER_HPP_
+#define _UXR_AGENT_UTILS_PACER_HPP_
+
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+
+namespace eprosima {
+namespace uxr {
+namespace utils {
+
+/**
+ * @brief The Pacer class spaces the packets sent to a destination so that they leave at a given
+ *        byte rate, letting at most burst bytes go back-to-back. Unlike a TokenBucket, which
+ *        grants up to a second worth of traffic at once, it smooths the output at packet level.
+ *        It is not thread-safe: the output scheduler owns the calls.
+ */
+class Pacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    Pacer(size_t rate, size_t burst)
+        : rate_(std::max(rate, size_t(1))),
+          tolerance_(emission_time(burst)),
+          release_()
+    {}
+
+    size_t rate() const { return rate_; }
+
+    /**
+     * @brief Time left until a packet of the given size may be sent.
+     */
+    std::chrono::microseconds delay(size_t size, Clock::time_point now = Clock::now()) const
+    {
+        std::chrono::nanoseconds wait = release_ - tolerance_ + emission_time(size) - now;
+        return (wait.count() <= 0)
+               ? std::chrono::microseconds(0)
+               : std::chrono::microseconds((wait.count() + 999) / 1000);
+    }
+
+    void on_sent(size_t size, Clock::time_point now = Clock::now())
+    {
+        release_ = std::max(release_, now) + emission_time(size);
+    }
+
+private:
+    std::chrono::nanoseconds emission_time(size_t size) const
+    {
+        return std::chrono::nanoseconds(int64_t(size / rate_) * 1000000000 +
+                                        int64_t(size % rate_) * 1000000000 / int64_t(rate_));
+    }
+
+private:
+    size_t rate_;
+    std::chrono::nanoseconds tolerance_;
+    Clock::time_point release_;
+};
+
+} // namespace utils
+} // namespace uxr
+} // namespace eprosima
+
+#endif //_UXR_AGENT_UTILS_PACER_HPP_
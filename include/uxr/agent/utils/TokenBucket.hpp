@@ -16,16 +16,27 @@
 #define _UXR_UTILS_DATAREADER_TOKENBUCKET_HPP_
 
 #include <chrono>
-#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
 
 namespace eprosima {
 namespace uxr {
 namespace utils {
 
+/**
+ * @brief The TokenBucket class limits a byte rate following the generic cell rate algorithm:
+ *        the bucket only keeps the theoretical arrival time of the next byte, in nanoseconds,
+ *        which is updated lock-free.
+ *        A bucket may have a parent (e.g. reader -> client -> link), and tokens are only granted
+ *        when every bucket up the hierarchy grants them.
+ *        The capacity is the burst, or one second of the rate without burst. A request larger than
+ *        the capacity is granted once the bucket is full, so that it does not wait forever.
+ */
 class TokenBucket
 {
 public:
-    explicit TokenBucket(size_t rate, size_t burst = min_rate_);
+    explicit TokenBucket(size_t rate, size_t burst = 0, std::shared_ptr<TokenBucket> parent = nullptr);
     TokenBucket(TokenBucket&& other) noexcept;
     TokenBucket(const TokenBucket& other);
     TokenBucket& operator=(TokenBucket&& other) noexcept;
@@ -33,18 +44,23 @@ public:
     ~TokenBucket()       = default;
 
     bool get_tokens(size_t tokens);
+    std::chrono::milliseconds time_to_tokens(size_t tokens);
+    void refund_tokens(size_t tokens);
+    const std::shared_ptr<TokenBucket>& parent() const { return parent_; }
+    size_t rate() const { return rate_; }
+    size_t capacity() const { return capacity_; }
 
 private:
-    size_t available_tokens();
+    int64_t emission_time(size_t tokens) const;
+    static int64_t now();
 
 private:
-    static constexpr size_t min_rate_ = 64000; // 64KB
+    static constexpr size_t default_rate_ = 64000; // 64KB
     size_t capacity_;
-    size_t tokens_;
     size_t rate_;
-    std::chrono::steady_clock::time_point timestamp_;
-
-    std::mutex data_mutex_;
+    int64_t tolerance_;
+    std::atomic<int64_t> tat_;
+    std::shared_ptr<TokenBucket> parent_;
 };
 } // namespace utils
 } // namespace uxr
@@ -22,6 +22,7 @@
 #include <termios.h>
 #include <fcntl.h>
 #endif //_WIN32
+#include <uxr/agent/participant/ParticipantPool.hpp>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -41,6 +42,8 @@ void showHelp()
     std::cout << "    udp <local_port> [<discovery_port>]" << std::endl;
     std::cout << "    tcp <local_port> [<discovery_port>]" << std::endl;
 #endif
+    std::cout << "Options:" << std::endl;
+    std::cout << "    --prewarm <profile>|<domain_id>[:<count>]" << std::endl;
 }
 
 void initializationError()
@@ -70,10 +73,53 @@ uint16_t parsePort(const std::string& str_port)
     return valid_port;
 }
 
+struct WarmOption
+{
+    std::string profile;
+    bool by_domain;
+    uint16_t domain_id;
+    size_t count;
+};
+
+WarmOption parseWarmOption(const std::string& str_option)
+{
+    WarmOption option{str_option, false, 0, 1};
+    std::string::size_type colon = str_option.rfind(':');
+    try
+    {
+        if (std::string::npos != colon)
+        {
+            int count = std::stoi(str_option.substr(colon + 1));
+            if (0 >= count)
+            {
+                initializationError();
+            }
+            option.count = size_t(count);
+            option.profile = str_option.substr(0, colon);
+        }
+        if (!option.profile.empty() &&
+            (std::string::npos == option.profile.find_first_not_of("0123456789")))
+        {
+            option.by_domain = true;
+            option.domain_id = parsePort(option.profile);
+        }
+    }
+    catch (const std::exception& )
+    {
+        initializationError();
+    }
+    if (option.profile.empty())
+    {
+        initializationError();
+    }
+    return option;
+}
+
 int main(int argc, char** argv)
 {
     eprosima::uxr::Server* server = nullptr;
     std::vector<std::string> cl(0);
+    std::vector<WarmOption> warm_options;
 
     if (1 == argc)
     {
@@ -95,6 +141,24 @@ int main(int argc, char** argv)
         }
     }
 
+    /* Options go anywhere on the command line, the command is what remains. */
+    for (auto it = cl.begin(); it != cl.end();)
+    {
+        if ("--prewarm" == *it)
+        {
+            if (cl.end() == it + 1)
+            {
+                initializationError();
+            }
+            warm_options.push_back(parseWarmOption(*(it + 1)));
+            it = cl.erase(it, it + 2);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
     if((1 == cl.size()) && (("-h" == cl[0]) || ("--help" == cl[0])))
     {
         showHelp();
@@ -208,6 +272,18 @@ int main(int argc, char** argv)
 
     if (nullptr != server)
     {
+        /* The server loads the XML profiles, warm participants come after it. */
+        for (const auto& option : warm_options)
+        {
+            bool warm = option.by_domain
+                    ? eprosima::uxr::ParticipantPool::instance().prewarm(option.domain_id, option.count)
+                    : eprosima::uxr::ParticipantPool::instance().prewarm(option.profile, option.count);
+            if (!warm)
+            {
+                std::cout << "Error: prewarming '" << option.profile << "'." << std::endl;
+            }
+        }
+
         /* Launch server. */
         if (server->run())
         {
@@ -225,6 +301,7 @@ int main(int argc, char** argv)
         {
             std::cout << "ERROR" << std::endl;
         }
+        eprosima::uxr::ParticipantPool::instance().clear_warm();
     }
 
     return 0;
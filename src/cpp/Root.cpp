@@ -13,12 +13,15 @@
 // limitations under the License.
 
 #include <uxr/agent/Root.hpp>
+#include <uxr/agent/config.hpp>
+#include <uxr/agent/message/OutputMessage.hpp>
 #include <uxr/agent/libdev/MessageDebugger.h>
 #include <uxr/agent/libdev/MessageOutput.h>
 #include <fastrtps/xmlparser/XMLProfileManager.h>
 #include <fastcdr/Cdr.h>
 #include <memory>
 #include <chrono>
+#include <algorithm>
 
 #ifdef WIN32
     #include <windows.h>
@@ -33,11 +36,19 @@ namespace uxr {
 
 Root::Root()
     : mtx_(),
+      link_budget_(),
       clients_(),
       current_client_()
 {
     current_client_ = clients_.begin();
 
+    /* Output budget shared by the clients of this transport, holding at least one whole message. */
+    if (0 != LINK_MAX_BYTES_PER_SECOND)
+    {
+        size_t burst = std::max(size_t(LINK_MAX_BYTES_PER_SECOND), OutputMessage::get_mtu_size());
+        link_budget_ = std::make_shared<utils::TokenBucket>(LINK_MAX_BYTES_PER_SECOND, burst);
+    }
+
     /* Load XML profile file. */
     if (fastrtps::xmlparser::XMLP_ret::XML_OK != fastrtps::xmlparser::XMLProfileManager::loadDefaultXMLFile())
     {
@@ -68,7 +79,7 @@ dds::xrce::ResultStatus Root::create_client(const dds::xrce::CLIENT_Representati
             auto it = clients_.find(client_key);
             if (it == clients_.end())
             {
-                std::shared_ptr<ProxyClient> new_client = std::make_shared<ProxyClient>(client_representation);
+                std::shared_ptr<ProxyClient> new_client = std::make_shared<ProxyClient>(client_representation, link_budget_);
                 if (clients_.insert(std::make_pair(client_key, std::move(new_client))).second)
                 {
 #ifdef VERBOSE_OUTPUT
@@ -86,7 +97,7 @@ dds::xrce::ResultStatus Root::create_client(const dds::xrce::CLIENT_Representati
                 std::shared_ptr<ProxyClient> client = clients_.at(client_key);
                 if (session_id != client->get_session_id())
                 {
-                    it->second = std::make_shared<ProxyClient>(client_representation);
+                    it->second = std::make_shared<ProxyClient>(client_representation, link_budget_);
                 }
                 else
                 {
@@ -0,0 +1,270 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "binobjects.h"
+
+#include <fastcdr/Cdr.h>
+#include <fastcdr/exceptions/Exception.h>
+#include <fastrtps/attributes/all_attributes.h>
+#include <fastrtps/xmlparser/XMLProfileManager.h>
+
+#include <iostream>
+#include <vector>
+
+using eprosima::fastrtps::ParticipantAttributes;
+using eprosima::fastrtps::PublisherAttributes;
+using eprosima::fastrtps::SubscriberAttributes;
+using eprosima::fastrtps::TopicAttributes;
+
+namespace {
+
+const uint16_t QOS_RELIABLE = 0x01;
+const uint16_t QOS_KEEP_LAST = 0x02;
+const uint16_t QOS_OWNERSHIP_EXCLUSIVE = 0x04;
+const uint16_t QOS_DURABILITY_MASK = 0x08 | 0x10 | 0x20;
+
+struct EndpointQos
+{
+    uint16_t flags = 0;
+    bool has_history_depth = false;
+    uint16_t history_depth = 0;
+    bool has_deadline = false;
+    uint32_t deadline_msec = 0;
+    bool has_lifespan = false;
+    uint32_t lifespan_msec = 0;
+    bool has_user_data = false;
+    std::vector<uint8_t> user_data;
+};
+
+eprosima::fastrtps::rtps::Duration_t to_duration(uint64_t msec)
+{
+    eprosima::fastrtps::rtps::Duration_t duration;
+    duration.seconds = int32_t(msec / 1000);
+    duration.fraction = uint32_t(((msec % 1000) << 32) / 1000);
+    return duration;
+}
+
+/*
+ * Runs the deserialization of a whole representation: anything left behind or missing fails it.
+ */
+template<typename F>
+bool deserialize(const uint8_t* source, std::size_t source_size, F&& body)
+{
+    bool rv = false;
+    eprosima::fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(const_cast<uint8_t*>(source)), source_size);
+    eprosima::fastcdr::Cdr deserializer(fastbuffer, eprosima::fastcdr::Cdr::LITTLE_ENDIANNESS);
+    try
+    {
+        rv = body(deserializer) && (source_size == deserializer.getSerializedDataLength());
+    }
+    catch(eprosima::fastcdr::exception::NotEnoughMemoryException & /*exception*/)
+    {
+        std::cout << "deserialize eprosima::fastcdr::exception::NotEnoughMemoryException" << std::endl;
+        rv = false;
+    }
+    return rv;
+}
+
+void deserialize_endpoint_qos(eprosima::fastcdr::Cdr& deserializer, EndpointQos& qos)
+{
+    deserializer >> qos.flags;
+    deserializer >> qos.has_history_depth;
+    if (qos.has_history_depth)
+    {
+        deserializer >> qos.history_depth;
+    }
+    deserializer >> qos.has_deadline;
+    if (qos.has_deadline)
+    {
+        deserializer >> qos.deadline_msec;
+    }
+    deserializer >> qos.has_lifespan;
+    if (qos.has_lifespan)
+    {
+        deserializer >> qos.lifespan_msec;
+    }
+    deserializer >> qos.has_user_data;
+    if (qos.has_user_data)
+    {
+        deserializer >> qos.user_data;
+    }
+}
+
+/*
+ * QoS common to writers and readers; the members left out keep the fastrtps defaults.
+ */
+template<typename Qos>
+void apply_endpoint_qos(const EndpointQos& qos, TopicAttributes& topic, Qos& endpoint_qos)
+{
+    endpoint_qos.m_reliability.kind = (qos.flags & QOS_RELIABLE)
+            ? eprosima::fastrtps::RELIABLE_RELIABILITY_QOS
+            : eprosima::fastrtps::BEST_EFFORT_RELIABILITY_QOS;
+    endpoint_qos.m_ownership.kind = (qos.flags & QOS_OWNERSHIP_EXCLUSIVE)
+            ? eprosima::fastrtps::EXCLUSIVE_OWNERSHIP_QOS
+            : eprosima::fastrtps::SHARED_OWNERSHIP_QOS;
+    /* Samples are kept for late joiners as long as the RTPS participant lives, whichever the kind. */
+    endpoint_qos.m_durability.kind = (qos.flags & QOS_DURABILITY_MASK)
+            ? eprosima::fastrtps::TRANSIENT_LOCAL_DURABILITY_QOS
+            : eprosima::fastrtps::VOLATILE_DURABILITY_QOS;
+    topic.historyQos.kind = (qos.flags & QOS_KEEP_LAST)
+            ? eprosima::fastrtps::KEEP_LAST_HISTORY_QOS
+            : eprosima::fastrtps::KEEP_ALL_HISTORY_QOS;
+    if (qos.has_history_depth)
+    {
+        topic.historyQos.depth = qos.history_depth;
+    }
+    if (qos.has_deadline)
+    {
+        endpoint_qos.m_deadline.period = to_duration(qos.deadline_msec);
+    }
+    if (qos.has_lifespan)
+    {
+        endpoint_qos.m_lifespan.duration = to_duration(qos.lifespan_msec);
+    }
+    if (qos.has_user_data)
+    {
+        endpoint_qos.m_userData.setDataVec(qos.user_data);
+    }
+}
+
+} // unnamed namespace
+
+bool eprosima::uxr::binobjects::parse_participant(const uint8_t* source, std::size_t source_size, uint16_t domain_id,
+                                                  ParticipantAttributes& participant)
+{
+    std::string qos_profile_reference;
+    bool has_qos_profile_reference = false;
+    bool rv = deserialize(source, source_size, [&](eprosima::fastcdr::Cdr& deserializer)
+    {
+        bool has_domain_reference;
+        deserializer >> has_domain_reference;
+        if (has_domain_reference)
+        {
+            std::string domain_reference;
+            deserializer >> domain_reference;
+        }
+        deserializer >> has_qos_profile_reference;
+        if (has_qos_profile_reference)
+        {
+            deserializer >> qos_profile_reference;
+        }
+        return true;
+    });
+
+    if (rv)
+    {
+        ParticipantAttributes attributes;
+        if (has_qos_profile_reference)
+        {
+            rv = (fastrtps::xmlparser::XMLP_ret::XML_OK ==
+                  fastrtps::xmlparser::XMLProfileManager::fillParticipantAttributes(qos_profile_reference, attributes));
+        }
+        if (rv)
+        {
+            attributes.rtps.builtin.domainId = domain_id;
+            participant = attributes;
+        }
+    }
+    return rv;
+}
+
+bool eprosima::uxr::binobjects::parse_topic(const uint8_t* source, std::size_t source_size, TopicAttributes& topic)
+{
+    return deserialize(source, source_size, [&](eprosima::fastcdr::Cdr& deserializer)
+    {
+        bool has_type_reference;
+        bool has_type_identifier;
+        TopicAttributes attributes;
+        deserializer >> attributes.topicName;
+        deserializer >> has_type_reference;
+        if (has_type_reference)
+        {
+            deserializer >> attributes.topicDataType;
+        }
+        deserializer >> has_type_identifier;
+
+        /* Types are known by name only. */
+        bool rv = has_type_reference && !has_type_identifier;
+        if (rv)
+        {
+            attributes.topicKind = fastrtps::rtps::NO_KEY;
+            topic = attributes;
+        }
+        return rv;
+    });
+}
+
+bool eprosima::uxr::binobjects::parse_datawriter(const uint8_t* source, std::size_t source_size,
+                                                 std::string& topic_name, PublisherAttributes& publisher)
+{
+    return deserialize(source, source_size, [&](eprosima::fastcdr::Cdr& deserializer)
+    {
+        PublisherAttributes attributes;
+        bool has_qos;
+        deserializer >> topic_name;
+        deserializer >> has_qos;
+        if (has_qos)
+        {
+            EndpointQos qos;
+            bool has_ownership_strength;
+            deserialize_endpoint_qos(deserializer, qos);
+            apply_endpoint_qos(qos, attributes.topic, attributes.qos);
+            deserializer >> has_ownership_strength;
+            if (has_ownership_strength)
+            {
+                uint64_t ownership_strength;
+                deserializer >> ownership_strength;
+                attributes.qos.m_ownershipStrength.value = uint32_t(ownership_strength);
+            }
+        }
+        publisher = attributes;
+        return true;
+    });
+}
+
+bool eprosima::uxr::binobjects::parse_datareader(const uint8_t* source, std::size_t source_size,
+                                                 std::string& topic_name, SubscriberAttributes& subscriber,
+                                                 std::string& content_filter)
+{
+    return deserialize(source, source_size, [&](eprosima::fastcdr::Cdr& deserializer)
+    {
+        SubscriberAttributes attributes;
+        bool has_qos;
+        content_filter.clear();
+        deserializer >> topic_name;
+        deserializer >> has_qos;
+        if (has_qos)
+        {
+            EndpointQos qos;
+            bool has_timebasedfilter;
+            bool has_contentbased_filter;
+            deserialize_endpoint_qos(deserializer, qos);
+            apply_endpoint_qos(qos, attributes.topic, attributes.qos);
+            deserializer >> has_timebasedfilter;
+            if (has_timebasedfilter)
+            {
+                uint64_t timebasedfilter_msec;
+                deserializer >> timebasedfilter_msec;
+                attributes.qos.m_timeBasedFilter.minimum_separation = to_duration(timebasedfilter_msec);
+            }
+            deserializer >> has_contentbased_filter;
+            if (has_contentbased_filter)
+            {
+                deserializer >> content_filter;
+            }
+        }
+        subscriber = attributes;
+        return true;
+    });
+}
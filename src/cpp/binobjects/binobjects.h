@@ -0,0 +1,62 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _BIN_OBJECTS_H
+#define _BIN_OBJECTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace eprosima {
+
+namespace fastrtps {
+class ParticipantAttributes;
+class PublisherAttributes;
+class SubscriberAttributes;
+class TopicAttributes;
+} // namespace fastrtps
+namespace uxr {
+namespace binobjects {
+
+/*
+ * REPRESENTATION_IN_BINARY payloads, little endian CDR, "optional" being a boolean followed by the
+ * member when true:
+ *
+ *  participant: optional string domain_reference (ignored), optional string qos_profile_reference
+ *  topic:       string topic_name, optional string type_reference, optional type_identifier (unsupported)
+ *  datawriter:  string topic_name, optional { endpoint_qos, optional uint64 ownership_strength }
+ *  datareader:  string topic_name, optional { endpoint_qos, optional uint64 timebasedfilter_msec,
+ *                                             optional string contentbased_filter }
+ *
+ *  endpoint_qos: uint16 qos_flags, optional uint16 history_depth, optional uint32 deadline_msec,
+ *                optional uint32 lifespan_msec, optional sequence<octet> user_data
+ *  qos_flags:    0x01 reliable, 0x02 keep last, 0x04 exclusive ownership,
+ *                0x08 | 0x10 | 0x20 transient local, transient or persistent durability
+ *
+ * The endpoints name their topic, whose type the caller resolves from the topics of the participant.
+ */
+bool parse_participant(const uint8_t* source, std::size_t source_size, uint16_t domain_id,
+                       eprosima::fastrtps::ParticipantAttributes& participant);
+bool parse_topic(const uint8_t* source, std::size_t source_size, eprosima::fastrtps::TopicAttributes& topic);
+bool parse_datawriter(const uint8_t* source, std::size_t source_size, std::string& topic_name,
+                      eprosima::fastrtps::PublisherAttributes& publisher);
+bool parse_datareader(const uint8_t* source, std::size_t source_size, std::string& topic_name,
+                      eprosima::fastrtps::SubscriberAttributes& subscriber, std::string& content_filter);
+
+} // namespace binobjects
+} // namespace uxr
+} // namespace eprosima
+
+#endif // !_BIN_OBJECTS_H
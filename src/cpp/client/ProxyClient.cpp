@@ -18,6 +18,11 @@
 #include <uxr/agent/datareader/DataReader.hpp>
 #include <uxr/agent/datawriter/DataWriter.hpp>
 #include <uxr/agent/topic/Topic.hpp>
+#include <uxr/agent/message/OutputMessage.hpp>
+#include <uxr/agent/config.hpp>
+
+#include <algorithm>
+#include <cstdlib>
 #ifdef VERBOSE_OUTPUT
 #include <uxr/agent/libdev/MessageDebugger.h>
 #include <uxr/agent/libdev/MessageOutput.h>
@@ -26,11 +31,102 @@
 namespace eprosima {
 namespace uxr {
 
-ProxyClient::ProxyClient(const dds::xrce::CLIENT_Representation& representation)
+ProxyClient::ProxyClient(const dds::xrce::CLIENT_Representation& representation,
+                         const std::shared_ptr<utils::TokenBucket>& link_budget)
     : representation_(representation),
+      keep_latest_(false),
+      budget_(),
+      waiters_mtx_(),
+      output_window_waiters_(),
+      heartbeat_mtx_(),
+      heartbeat_timers_(),
       objects_(),
       session_()
 {
+    /* Opt-in keep-latest conflation of the samples waiting for link budget. */
+    uint32_t max_bytes_per_second = CLIENT_MAX_BYTES_PER_SECOND;
+    if (representation_.properties())
+    {
+        for (const auto& property : *representation_.properties())
+        {
+            if ("uxr_keep_latest" == property.name())
+            {
+                keep_latest_ = ("true" == property.value()) || ("1" == property.value());
+            }
+            else if ("uxr_congestion_control" == property.name())
+            {
+                session_.set_congestion_control("aimd" == property.value());
+            }
+            else if ("uxr_fec_group" == property.name())
+            {
+                /* One parity per K messages of every reliable output stream, a single message is no group. */
+                unsigned long group_size = std::strtoul(property.value().c_str(), nullptr, 10);
+                session_.set_fec_group((1 < group_size) ? uint8_t(std::min(group_size, 16ul)) : 0);
+            }
+            else if ("uxr_max_bytes_per_second" == property.name())
+            {
+                max_bytes_per_second = uint32_t(std::strtoul(property.value().c_str(), nullptr, 10));
+            }
+        }
+    }
+
+    /* Aggregated output budget at the requested rate, drawn from the link one.
+       It holds at least one whole message. */
+    if (0 != max_bytes_per_second)
+    {
+        size_t burst = std::max(size_t(max_bytes_per_second), OutputMessage::get_mtu_size());
+        budget_ = std::make_shared<utils::TokenBucket>(max_bytes_per_second, burst, link_budget);
+    }
+    else
+    {
+        budget_ = link_budget;
+    }
+}
+
+ProxyClient::~ProxyClient()
+{
+    std::lock_guard<std::mutex> lock(heartbeat_mtx_);
+    for (const auto& heartbeat_timer : heartbeat_timers_)
+    {
+        Executor::instance().cancel(heartbeat_timer.second);
+    }
+}
+
+void ProxyClient::wait_output_window(dds::xrce::StreamId stream_id, const dds::xrce::ObjectId& object_id)
+{
+    std::lock_guard<std::mutex> lock(waiters_mtx_);
+    output_window_waiters_[stream_id].insert(object_id);
+}
+
+std::vector<dds::xrce::ObjectId> ProxyClient::take_output_window_waiters(dds::xrce::StreamId stream_id)
+{
+    std::vector<dds::xrce::ObjectId> rv;
+    std::lock_guard<std::mutex> lock(waiters_mtx_);
+    auto it = output_window_waiters_.find(stream_id);
+    if (output_window_waiters_.end() != it)
+    {
+        rv.assign(it->second.begin(), it->second.end());
+        output_window_waiters_.erase(it);
+    }
+    return rv;
+}
+
+bool ProxyClient::heartbeat_armed(dds::xrce::StreamId stream_id)
+{
+    std::lock_guard<std::mutex> lock(heartbeat_mtx_);
+    return heartbeat_timers_.end() != heartbeat_timers_.find(stream_id);
+}
+
+void ProxyClient::arm_heartbeat(dds::xrce::StreamId stream_id, Executor::TimerId timer_id)
+{
+    std::lock_guard<std::mutex> lock(heartbeat_mtx_);
+    heartbeat_timers_[stream_id] = timer_id;
+}
+
+void ProxyClient::disarm_heartbeat(dds::xrce::StreamId stream_id)
+{
+    std::lock_guard<std::mutex> lock(heartbeat_mtx_);
+    heartbeat_timers_.erase(stream_id);
 }
 
 dds::xrce::ResultStatus ProxyClient::create(const dds::xrce::CreationMode& creation_mode,
@@ -314,7 +410,7 @@ bool ProxyClient::create_datareader(const dds::xrce::ObjectId& object_id,
         if (it != objects_.end())
         {
             std::shared_ptr<Subscriber> subscriber = std::dynamic_pointer_cast<Subscriber>(it->second);
-            std::shared_ptr<DataReader> datareader(new DataReader(object_id, subscriber));
+            std::shared_ptr<DataReader> datareader(new DataReader(object_id, subscriber, budget_));
             if (datareader->init(representation, objects_))
             {
                 rv = objects_.insert(std::make_pair(object_id, std::move(datareader))).second;
@@ -0,0 +1,543 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/datareader/ContentFilter.hpp>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace eprosima {
+namespace uxr {
+
+namespace {
+
+bool equals_keyword(const std::string& token, const char* keyword)
+{
+    size_t len = std::strlen(keyword);
+    if (token.size() != len)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < len; ++i)
+    {
+        if (std::toupper(static_cast<unsigned char>(token[i])) != keyword[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // unnamed namespace
+
+/*
+ * Recursive descent parser which emits the expression in postfix order.
+ *
+ *   filter     := [ '{' member { ';' member } [ ';' ] '}' ] expression
+ *   member     := type identifier
+ *   expression := term { OR term }
+ *   term       := factor { AND factor }
+ *   factor     := NOT factor | '(' expression ')' | operand comparator operand
+ *   operand    := identifier | number | 'string'
+ */
+class ContentFilter::Parser
+{
+public:
+    Parser(const std::string& text, ContentFilter& filter)
+        : text_(text),
+          pos_(0),
+          filter_(filter),
+          names_()
+    {}
+
+    bool parse()
+    {
+        skip_spaces();
+        if (peek('{') && !parse_members())
+        {
+            return false;
+        }
+        if (!parse_expression())
+        {
+            return false;
+        }
+        skip_spaces();
+        return pos_ == text_.size();
+    }
+
+private:
+    void skip_spaces()
+    {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])))
+        {
+            ++pos_;
+        }
+    }
+
+    bool peek(char c)
+    {
+        skip_spaces();
+        return pos_ < text_.size() && text_[pos_] == c;
+    }
+
+    bool accept(char c)
+    {
+        bool rv = peek(c);
+        if (rv)
+        {
+            ++pos_;
+        }
+        return rv;
+    }
+
+    bool read_identifier(std::string& identifier)
+    {
+        skip_spaces();
+        size_t begin = pos_;
+        if (pos_ < text_.size() && (std::isalpha(static_cast<unsigned char>(text_[pos_])) || '_' == text_[pos_]))
+        {
+            ++pos_;
+            while (pos_ < text_.size() &&
+                   (std::isalnum(static_cast<unsigned char>(text_[pos_])) || '_' == text_[pos_]))
+            {
+                ++pos_;
+            }
+        }
+        identifier = text_.substr(begin, pos_ - begin);
+        return !identifier.empty();
+    }
+
+    bool accept_keyword(const char* keyword)
+    {
+        size_t begin = pos_;
+        std::string identifier;
+        if (read_identifier(identifier) && equals_keyword(identifier, keyword))
+        {
+            return true;
+        }
+        pos_ = begin;
+        return false;
+    }
+
+    bool parse_members()
+    {
+        static const std::map<std::string, MemberKind> types = {
+            {"boolean", MemberKind::BOOLEAN},
+            {"octet",   MemberKind::UINT8},
+            {"char",    MemberKind::INT8},
+            {"int8",    MemberKind::INT8},
+            {"uint8",   MemberKind::UINT8},
+            {"int16",   MemberKind::INT16},
+            {"uint16",  MemberKind::UINT16},
+            {"short",   MemberKind::INT16},
+            {"int32",   MemberKind::INT32},
+            {"uint32",  MemberKind::UINT32},
+            {"long",    MemberKind::INT32},
+            {"int64",   MemberKind::INT64},
+            {"uint64",  MemberKind::UINT64},
+            {"float32", MemberKind::FLOAT32},
+            {"float",   MemberKind::FLOAT32},
+            {"float64", MemberKind::FLOAT64},
+            {"double",  MemberKind::FLOAT64},
+            {"string",  MemberKind::STRING}
+        };
+
+        accept('{');
+        while (!accept('}'))
+        {
+            std::string type_name;
+            std::string member_name;
+            if (!read_identifier(type_name) || !read_identifier(member_name))
+            {
+                return false;
+            }
+            auto type = types.find(type_name);
+            if (types.end() == type || names_.count(member_name))
+            {
+                return false;
+            }
+            names_.emplace(member_name, filter_.members_.size());
+            filter_.members_.push_back(type->second);
+            if (!accept(';') && !peek('}'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool parse_expression()
+    {
+        if (!parse_term())
+        {
+            return false;
+        }
+        while (accept_keyword("OR"))
+        {
+            if (!parse_term())
+            {
+                return false;
+            }
+            emit(OpCode::OR);
+        }
+        return true;
+    }
+
+    bool parse_term()
+    {
+        if (!parse_factor())
+        {
+            return false;
+        }
+        while (accept_keyword("AND"))
+        {
+            if (!parse_factor())
+            {
+                return false;
+            }
+            emit(OpCode::AND);
+        }
+        return true;
+    }
+
+    bool parse_factor()
+    {
+        if (accept_keyword("NOT"))
+        {
+            if (!parse_factor())
+            {
+                return false;
+            }
+            emit(OpCode::NOT);
+            return true;
+        }
+        if (accept('('))
+        {
+            return parse_expression() && accept(')');
+        }
+
+        OpCode comparator;
+        return parse_operand() && parse_comparator(comparator) && parse_operand() && (emit(comparator), true);
+    }
+
+    bool parse_comparator(OpCode& comparator)
+    {
+        skip_spaces();
+        static const std::pair<const char*, OpCode> comparators[] = {
+            {"<>", OpCode::NOT_EQUAL},
+            {"!=", OpCode::NOT_EQUAL},
+            {"<=", OpCode::LESS_EQUAL},
+            {">=", OpCode::GREATER_EQUAL},
+            {"==", OpCode::EQUAL},
+            {"=",  OpCode::EQUAL},
+            {"<",  OpCode::LESS},
+            {">",  OpCode::GREATER}
+        };
+        for (const auto& c : comparators)
+        {
+            size_t len = std::strlen(c.first);
+            if (0 == text_.compare(pos_, len, c.first))
+            {
+                pos_ += len;
+                comparator = c.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parse_operand()
+    {
+        skip_spaces();
+        if (pos_ >= text_.size())
+        {
+            return false;
+        }
+
+        char c = text_[pos_];
+        if ('\'' == c)
+        {
+            size_t end = text_.find('\'', pos_ + 1);
+            if (std::string::npos == end)
+            {
+                return false;
+            }
+            filter_.literal_strings_.push_back(text_.substr(pos_ + 1, end - pos_ - 1));
+            pos_ = end + 1;
+            Value value{ValueKind::STRING, 0, 0.0, nullptr, 0};
+            value.integer = int64_t(filter_.literal_strings_.size() - 1);
+            return push_literal(value);
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(c)) || '-' == c || '+' == c || '.' == c)
+        {
+            const char* begin = text_.c_str() + pos_;
+            char* end = nullptr;
+            Value value{ValueKind::INTEGER, 0, 0.0, nullptr, 0};
+            value.integer = std::strtoll(begin, &end, 10);
+            if (end != begin && '.' != *end && 'e' != *end && 'E' != *end)
+            {
+                value.real = double(value.integer);
+            }
+            else
+            {
+                value.kind = ValueKind::REAL;
+                value.real = std::strtod(begin, &end);
+                if (end == begin)
+                {
+                    return false;
+                }
+            }
+            pos_ += size_t(end - begin);
+            return push_literal(value);
+        }
+
+        std::string identifier;
+        if (!read_identifier(identifier))
+        {
+            return false;
+        }
+        auto it = names_.find(identifier);
+        if (names_.end() == it)
+        {
+            return false;
+        }
+        if (it->second + 1 > filter_.members_used_)
+        {
+            filter_.members_used_ = it->second + 1;
+        }
+        filter_.program_.push_back(Instruction{OpCode::PUSH_MEMBER, it->second});
+        return true;
+    }
+
+    bool push_literal(const Value& value)
+    {
+        filter_.program_.push_back(Instruction{OpCode::PUSH_LITERAL, filter_.literals_.size()});
+        filter_.literals_.push_back(value);
+        return true;
+    }
+
+    void emit(OpCode op)
+    {
+        filter_.program_.push_back(Instruction{op, 0});
+    }
+
+private:
+    const std::string& text_;
+    size_t pos_;
+    ContentFilter& filter_;
+    std::map<std::string, size_t> names_;
+};
+
+bool ContentFilter::compile(const std::string& expression)
+{
+    *this = ContentFilter();
+    Parser parser(expression, *this);
+    if (!parser.parse() || program_.empty())
+    {
+        *this = ContentFilter();
+        return false;
+    }
+
+    /* String literals are only referenced once the storage is stable. */
+    for (auto& literal : literals_)
+    {
+        if (ValueKind::STRING == literal.kind)
+        {
+            const std::string& str = literal_strings_[size_t(literal.integer)];
+            literal.str = str.c_str();
+            literal.len = str.size();
+        }
+    }
+    return true;
+}
+
+bool ContentFilter::evaluate(const uint8_t* data, size_t size) const
+{
+    if (program_.empty())
+    {
+        return true;
+    }
+
+    std::vector<Value> members;
+    if (!decode_members(data, size, members))
+    {
+        return false;
+    }
+
+    /* Booleans are kept in the same stack as operands. */
+    std::vector<Value> stack;
+    stack.reserve(program_.size());
+    for (const auto& instruction : program_)
+    {
+        switch (instruction.op)
+        {
+            case OpCode::PUSH_MEMBER:
+                stack.push_back(members[instruction.index]);
+                break;
+            case OpCode::PUSH_LITERAL:
+                stack.push_back(literals_[instruction.index]);
+                break;
+            case OpCode::NOT:
+                stack.back().integer = !stack.back().integer;
+                break;
+            case OpCode::AND:
+            case OpCode::OR:
+            {
+                int64_t rhs = stack.back().integer;
+                stack.pop_back();
+                int64_t& lhs = stack.back().integer;
+                lhs = (OpCode::AND == instruction.op) ? (lhs && rhs) : (lhs || rhs);
+                break;
+            }
+            default:
+            {
+                Value rhs = stack.back();
+                stack.pop_back();
+                Value& lhs = stack.back();
+                int result = compare(lhs, rhs);
+                bool match = false;
+                switch (instruction.op)
+                {
+                    case OpCode::EQUAL:         match = (0 == result); break;
+                    case OpCode::NOT_EQUAL:     match = (0 != result); break;
+                    case OpCode::LESS:          match = (-1 == result); break;
+                    case OpCode::LESS_EQUAL:    match = (-1 == result || 0 == result); break;
+                    case OpCode::GREATER:       match = (1 == result); break;
+                    case OpCode::GREATER_EQUAL: match = (1 == result || 0 == result); break;
+                    default: break;
+                }
+                lhs = Value{ValueKind::INTEGER, match, 0.0, nullptr, 0};
+                break;
+            }
+        }
+    }
+    return !stack.empty() && (0 != stack.back().integer);
+}
+
+bool ContentFilter::decode_members(const uint8_t* data, size_t size, std::vector<Value>& values) const
+{
+    values.reserve(members_used_);
+    size_t offset = 0;
+    for (size_t i = 0; i < members_used_; ++i)
+    {
+        size_t width;
+        switch (members_[i])
+        {
+            case MemberKind::BOOLEAN:
+            case MemberKind::INT8:
+            case MemberKind::UINT8:   width = 1; break;
+            case MemberKind::INT16:
+            case MemberKind::UINT16:  width = 2; break;
+            case MemberKind::INT64:
+            case MemberKind::UINT64:
+            case MemberKind::FLOAT64: width = 8; break;
+            default:                  width = 4; break;
+        }
+        offset = (offset + width - 1) & ~(width - 1);
+        if (offset + width > size)
+        {
+            return false;
+        }
+
+        /* Samples are little endian, as serialized by the clients. */
+        uint64_t raw = 0;
+        for (size_t b = 0; b < width; ++b)
+        {
+            raw |= uint64_t(data[offset + b]) << (8 * b);
+        }
+        offset += width;
+
+        Value value{ValueKind::INTEGER, 0, 0.0, nullptr, 0};
+        switch (members_[i])
+        {
+            case MemberKind::BOOLEAN: value.integer = (0 != raw); break;
+            case MemberKind::INT8:    value.integer = int8_t(raw); break;
+            case MemberKind::UINT8:   value.integer = uint8_t(raw); break;
+            case MemberKind::INT16:   value.integer = int16_t(raw); break;
+            case MemberKind::UINT16:  value.integer = uint16_t(raw); break;
+            case MemberKind::INT32:   value.integer = int32_t(raw); break;
+            case MemberKind::UINT32:  value.integer = uint32_t(raw); break;
+            case MemberKind::INT64:   value.integer = int64_t(raw); break;
+            case MemberKind::UINT64:  value.integer = int64_t(raw); break;
+            case MemberKind::FLOAT32:
+            {
+                uint32_t bits = uint32_t(raw);
+                float real;
+                std::memcpy(&real, &bits, sizeof(real));
+                value.kind = ValueKind::REAL;
+                value.real = real;
+                break;
+            }
+            case MemberKind::FLOAT64:
+            {
+                double real;
+                std::memcpy(&real, &raw, sizeof(real));
+                value.kind = ValueKind::REAL;
+                value.real = real;
+                break;
+            }
+            case MemberKind::STRING:
+            {
+                /* Length includes the null terminator. */
+                size_t length = size_t(uint32_t(raw));
+                if (0 == length || length > size - offset)
+                {
+                    return false;
+                }
+                value.kind = ValueKind::STRING;
+                value.str = reinterpret_cast<const char*>(data + offset);
+                value.len = length - 1;
+                offset += length;
+                break;
+            }
+        }
+        if (ValueKind::INTEGER == value.kind)
+        {
+            value.real = double(value.integer);
+        }
+        values.push_back(value);
+    }
+    return true;
+}
+
+int ContentFilter::compare(const Value& lhs, const Value& rhs)
+{
+    if ((ValueKind::STRING == lhs.kind) != (ValueKind::STRING == rhs.kind))
+    {
+        /* Mismatched operands never compare equal nor ordered. */
+        return 2;
+    }
+
+    if (ValueKind::STRING == lhs.kind)
+    {
+        int rv = std::memcmp(lhs.str, rhs.str, (lhs.len < rhs.len) ? lhs.len : rhs.len);
+        if (0 == rv)
+        {
+            rv = (lhs.len < rhs.len) ? -1 : ((lhs.len > rhs.len) ? 1 : 0);
+        }
+        return (rv < 0) ? -1 : ((rv > 0) ? 1 : 0);
+    }
+
+    if (ValueKind::INTEGER == lhs.kind && ValueKind::INTEGER == rhs.kind)
+    {
+        return (lhs.integer < rhs.integer) ? -1 : ((lhs.integer > rhs.integer) ? 1 : 0);
+    }
+    return (lhs.real < rhs.real) ? -1 : ((lhs.real > rhs.real) ? 1 : 0);
+}
+
+} // namespace uxr
+} // namespace eprosima
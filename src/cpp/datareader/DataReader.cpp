@@ -16,13 +16,15 @@
 #include <uxr/agent/subscriber/Subscriber.hpp>
 #include <uxr/agent/participant/Participant.hpp>
 #include <uxr/agent/topic/Topic.hpp>
-#include <uxr/agent/utils/TokenBucket.hpp>
+#include <uxr/agent/config.hpp>
 #include <fastrtps/Domain.h>
 #include <fastrtps/subscriber/SampleInfo.h>
 #include <fastrtps/subscriber/Subscriber.h>
 #include <fastrtps/xmlparser/XMLProfileManager.h>
-#include <atomic>
 #include "../xmlobjects/xmlobjects.h"
+#include "../binobjects/binobjects.h"
+
+#include <algorithm>
 
 #define DEFAULT_XRCE_PARTICIPANT_PROFILE "default_xrce_participant_profile"
 #define DEFAULT_XRCE_SUBSCRIBER_PROFILE "default_xrce_subscriber_profile"
@@ -32,12 +34,95 @@ namespace uxr {
 
 using utils::TokenBucket;
 
+namespace {
+
+size_t cdr_alignment(size_t offset, size_t alignment)
+{
+    return (alignment - (offset % alignment)) & (alignment - 1);
+}
+
+bool is_batch_format(dds::xrce::DataFormat format)
+{
+    return (dds::xrce::FORMAT_DATA_SEQ == format) ||
+           (dds::xrce::FORMAT_SAMPLE_SEQ == format) ||
+           (dds::xrce::FORMAT_PACKED_SAMPLES == format);
+}
+
+/*
+ * Serialized size of an empty DATA payload, BaseObjectRequest included.
+ * DATA payloads start 4-byte aligned, so sizes and alignments are computed from their beginning.
+ */
+size_t batch_initial_size(dds::xrce::DataFormat format)
+{
+    size_t size = 4; /* RequestId + ObjectId. */
+    switch (format)
+    {
+        case dds::xrce::FORMAT_DATA_SEQ:
+        case dds::xrce::FORMAT_SAMPLE_SEQ:
+            size += 4; /* Sequence length. */
+            break;
+        case dds::xrce::FORMAT_PACKED_SAMPLES:
+            size += 12 + 4; /* SampleInfo base + sequence length. */
+            break;
+        default:
+            break;
+    }
+    return size;
+}
+
+/*
+ * Serialized size of a DATA payload of the given size once a sample of data_size bytes is appended.
+ */
+size_t batch_next_size(dds::xrce::DataFormat format, size_t size, size_t data_size)
+{
+    switch (format)
+    {
+        case dds::xrce::FORMAT_SAMPLE:
+        case dds::xrce::FORMAT_SAMPLE_SEQ:
+            size += 1; /* SampleInfo state. */
+            size += cdr_alignment(size, 4) + 4 + 4; /* Sequence number + session time offset. */
+            break;
+        case dds::xrce::FORMAT_PACKED_SAMPLES:
+            size += 1 + 1; /* SampleInfoDelta state + sequence number delta. */
+            size += cdr_alignment(size, 2) + 2; /* Timestamp delta. */
+            break;
+        default:
+            break;
+    }
+    size += cdr_alignment(size, 4) + 4 + data_size; /* SampleData. */
+    return size;
+}
+
+} // unnamed namespace
+
 DataReader::DataReader(const dds::xrce::ObjectId& object_id,
                        const std::shared_ptr<Subscriber>& subscriber,
+                       const std::shared_ptr<utils::TokenBucket>& budget,
                        const std::string& profile_name)
     : XRCEObject(object_id),
       subscriber_(subscriber),
       running_cond_(false),
+      delivering_(false),
+      notified_(false),
+      read_id_(0),
+      rate_manager_(0, 0, budget),
+      message_count_(0),
+      sample_seq_(0),
+      creation_time_(std::chrono::steady_clock::now()),
+      next_pace_time_(),
+      paced_sample_(),
+      has_paced_sample_(false),
+      conflated_samples_(),
+      conflated_count_(0),
+      conflated_arrivals_(0),
+      held_filter_(),
+      pending_batch_(),
+      pending_handles_(),
+      pending_args_(),
+      pending_read_id_(0),
+      window_full_(false),
+      max_timer_(0),
+      retry_timer_(0),
       rtps_subscriber_prof_(profile_name),
       rtps_subscriber_(nullptr),
       topic_type_(false)
@@ -47,18 +132,16 @@ DataReader::DataReader(const dds::xrce::ObjectId& object_id,
 
 DataReader::~DataReader() noexcept
 {
-    stop_read();
-    if (read_thread_.joinable())
+    /*
+     * Pending tasks only keep a weak reference, and a running task keeps the reader alive,
+     * so no delivery can be in progress at this point.
+     * Timers left in the Executor will find the reader expired.
+     */
+    if (binding_)
     {
-        read_thread_.join();
+        shared_reader_->unbind(binding_);
     }
-
-    if (max_timer_thread_.joinable())
-    {
-        max_timer_thread_.join();
-    }
-
-    if (nullptr != rtps_subscriber_)
+    else if (nullptr != rtps_subscriber_)
     {
         fastrtps::Domain::removeSubscriber(rtps_subscriber_);
     }
@@ -72,55 +155,47 @@ DataReader::~DataReader() noexcept
 
 bool DataReader::init(const dds::xrce::DATAREADER_Representation& representation, const ObjectContainer& root_objects)
 {
-    bool rv = false;
-    fastrtps::Participant* rtps_participant = subscriber_->get_participant()->get_rtps_participant();
-    dds::xrce::ObjectId topic_id;
+    bool parsed = false;
+    fastrtps::SubscriberAttributes attributes;
     switch (representation.representation()._d())
     {
         case dds::xrce::REPRESENTATION_BY_REFERENCE:
         {
             const std::string& ref_rep = representation.representation().object_reference();
-            rtps_subscriber_ = fastrtps::Domain::createSubscriber(rtps_participant, ref_rep, this);
-            if (nullptr != rtps_subscriber_)
-            {
-                const std::string& topic_data_type = rtps_subscriber_->getAttributes().topic.getTopicDataType();
-                if (subscriber_->get_participant()->check_register_topic(topic_data_type, topic_id))
-                {
-                    topic_ = std::dynamic_pointer_cast<Topic>(root_objects.at(topic_id));
-                    topic_->tie_object(get_id());
-                    rv = true;
-                }
-            }
-            else
-            {
-                if (fastrtps::Domain::removeSubscriber(rtps_subscriber_))
-                {
-                    rtps_subscriber_ = nullptr;
-                }
-            }
+            parsed = (fastrtps::xmlparser::XMLP_ret::XML_OK ==
+                      fastrtps::xmlparser::XMLProfileManager::fillSubscriberAttributes(ref_rep, attributes));
             break;
         }
         case dds::xrce::REPRESENTATION_AS_XML_STRING:
         {
             const std::string& xml_rep = representation.representation().xml_string_representation();
-            fastrtps::SubscriberAttributes attributes;
-            if (xmlobjects::parse_subscriber(xml_rep.data(), xml_rep.size(), attributes))
+            parsed = xmlobjects::parse_subscriber(xml_rep.data(), xml_rep.size(), attributes);
+            break;
+        }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            const std::vector<uint8_t>& bin_rep = representation.representation().binary_representation();
+            std::string topic_name;
+            std::string content_filter;
+            if (binobjects::parse_datareader(bin_rep.data(), bin_rep.size(), topic_name, attributes, content_filter))
             {
-                rtps_subscriber_ = fastrtps::Domain::createSubscriber(rtps_participant, attributes, this);
-                if (nullptr != rtps_subscriber_)
+                std::shared_ptr<Topic> topic = Topic::find(root_objects, subscriber_->get_participant(), topic_name);
+                if (topic)
                 {
-                    if (subscriber_->get_participant()->check_register_topic(attributes.topic.getTopicDataType(), topic_id))
-                    {
-                        topic_ = std::dynamic_pointer_cast<Topic>(root_objects.at(topic_id));
-                        topic_->tie_object(get_id());
-                        rv = true;
-                    }
+                    attributes.topic.topicName = topic_name;
+                    attributes.topic.topicDataType = topic->get_type_name();
+                    attributes.topic.topicKind = topic->with_key() ? fastrtps::rtps::WITH_KEY : fastrtps::rtps::NO_KEY;
+                    binary_representation_ = bin_rep;
+                    parsed = true;
                 }
-                else
+                /* The content based filter applies to the reads without an expression of their own. */
+                if (parsed && !content_filter.empty())
                 {
-                    if (fastrtps::Domain::removeSubscriber(rtps_subscriber_))
+                    default_filter_ = std::make_shared<ContentFilter>();
+                    if (!default_filter_->compile(content_filter))
                     {
-                        rtps_subscriber_ = nullptr;
+                        std::cout << "Error: content filter expression not valid" << std::endl;
+                        parsed = false;
                     }
                 }
             }
@@ -129,12 +204,62 @@ bool DataReader::init(const dds::xrce::DATAREADER_Representation& representation
         default:
             break;
     }
+
+    bool rv = false;
+    dds::xrce::ObjectId topic_id;
+    if (parsed &&
+        subscriber_->get_participant()->check_register_topic(attributes.topic.getTopicDataType(), topic_id) &&
+        createRTPSSubscriber(subscriber_->get_participant()->get_rtps_participant(), attributes))
+    {
+        topic_ = std::dynamic_pointer_cast<Topic>(root_objects.at(topic_id));
+        topic_->tie_object(get_id());
+        rv = true;
+    }
     return rv;
 }
 
-void DataReader::read(const dds::xrce::READ_DATA_Payload& read_data,
+bool DataReader::createRTPSSubscriber(fastrtps::Participant* rtps_participant,
+                                      const fastrtps::SubscriberAttributes& attributes)
+{
+    if (!SHARED_READERS)
+    {
+        fastrtps::SubscriberAttributes rtps_attributes = attributes;
+        rtps_subscriber_ = fastrtps::Domain::createSubscriber(rtps_participant, rtps_attributes, this);
+        return (nullptr != rtps_subscriber_);
+    }
+
+    shared_reader_ = SharedReader::acquire(rtps_participant, attributes);
+    if (shared_reader_)
+    {
+        binding_ = shared_reader_->bind(
+                    [this]()
+                    {
+                        onNewDataMessage(nullptr);
+                    },
+                    [this](int delta)
+                    {
+                        matched_ += delta;
+                    });
+    }
+    return bool(binding_);
+}
+
+bool DataReader::read(const dds::xrce::READ_DATA_Payload& read_data,
                       read_callback read_cb, const ReadCallbackArgs& cb_args)
 {
+    /* The filter is compiled once per read and shared with the running delivery. */
+    std::shared_ptr<ContentFilter> content_filter = default_filter_;
+    if (read_data.read_specification().has_content_filter_expression() &&
+        !read_data.read_specification().content_filter_expression().empty())
+    {
+        content_filter = std::make_shared<ContentFilter>();
+        if (!content_filter->compile(read_data.read_specification().content_filter_expression()))
+        {
+            std::cout << "Error: content filter expression not valid" << std::endl;
+            return false;
+        }
+    }
+
     dds::xrce::DataDeliveryControl delivery_control;
     if (read_data.read_specification().has_delivery_control())
     {
@@ -147,25 +272,28 @@ void DataReader::read(const dds::xrce::READ_DATA_Payload& read_data,
         delivery_control.max_samples(1);
     }
 
+    ReadCallbackArgs read_args = cb_args;
     switch (read_data.read_specification().data_format())
     {
         case dds::xrce::FORMAT_DATA:
-            break;
         case dds::xrce::FORMAT_SAMPLE:
-            break;
         case dds::xrce::FORMAT_DATA_SEQ:
-            break;
         case dds::xrce::FORMAT_SAMPLE_SEQ:
-            break;
         case dds::xrce::FORMAT_PACKED_SAMPLES:
+            read_args.data_format = read_data.read_specification().data_format();
             break;
         default:
             std::cout << "Error: read format unexpected" << std::endl;
+            read_args.data_format = dds::xrce::FORMAT_DATA;
             break;
     }
 
+    std::lock_guard<std::mutex> lock(mtx_);
+    self_ = shared_from_this();
     stop_read();
-    start_read(delivery_control, read_cb, cb_args);
+    content_filter_ = std::move(content_filter);
+    start_read(delivery_control, read_cb, read_args);
+    return true;
 }
 
 bool DataReader::has_message() const
@@ -173,99 +301,309 @@ bool DataReader::has_message() const
     return msg_;
 }
 
-int DataReader::start_read(const dds::xrce::DataDeliveryControl& delivery_control, read_callback read_cb, const ReadCallbackArgs& cb_args)
+void DataReader::start_read(const dds::xrce::DataDeliveryControl& delivery_control,
+                            read_callback read_cb, const ReadCallbackArgs& cb_args)
 {
-    std::unique_lock<std::mutex> lock(mtx_);
+    /* A re-armed read with the same rate keeps its bucket, so re-issuing READ_DATA does not refill it. */
+    if (delivery_control.max_bytes_per_second() != delivery_control_.max_bytes_per_second())
+    {
+        rate_manager_ = TokenBucket{delivery_control.max_bytes_per_second(), 0, rate_manager_.parent()};
+    }
+
     running_cond_ = true;
-    lock.unlock();
+    ++read_id_;
+    delivery_control_ = delivery_control;
+    read_cb_ = read_cb;
+    cb_args_ = cb_args;
+    message_count_ = 0;
 
     if (delivery_control.max_elapsed_time() > 0)
     {
-        max_timer_thread_ = std::thread(&DataReader::run_max_timer, this, delivery_control.max_elapsed_time());
+        std::weak_ptr<DataReader> self = self_;
+        uint32_t read_id = read_id_;
+        max_timer_ = Executor::instance().schedule(
+                    std::chrono::milliseconds(delivery_control.max_elapsed_time()),
+                    [self, read_id]()
+                    {
+                        if (std::shared_ptr<DataReader> reader = self.lock())
+                        {
+                            reader->on_max_timeout(read_id);
+                        }
+                    });
     }
-    read_thread_ = std::thread(&DataReader::read_task, this, delivery_control, read_cb, cb_args);
 
-    return 0;
+    if (delivering_)
+    {
+        /* The running task picks up the new read. */
+        notified_ = true;
+    }
+    else
+    {
+        delivering_ = true;
+        post_delivery();
+    }
 }
 
-int DataReader::stop_read()
+void DataReader::stop_read()
 {
-    std::unique_lock<std::mutex> lock(mtx_);
     running_cond_ = false;
-    lock.unlock();
-    cond_var_.notify_one();
-
-    if (read_thread_.joinable())
+    if (0 != max_timer_)
     {
-        read_thread_.join();
+        Executor::instance().cancel(max_timer_);
+        max_timer_ = 0;
     }
-
-    stop_max_timer();
-    if (max_timer_thread_.joinable())
+    if ((0 != retry_timer_) && Executor::instance().cancel(retry_timer_))
     {
-        max_timer_thread_.join();
+        /* Nobody else is going to resume the delivery. */
+        delivering_ = false;
     }
-    return 0;
+    retry_timer_ = 0;
 }
 
-void DataReader::read_task(dds::xrce::DataDeliveryControl delivery_control,
-                           read_callback read_cb, ReadCallbackArgs cb_args)
+void DataReader::post_delivery()
 {
-    TokenBucket rate_manager{delivery_control.max_bytes_per_second()};
-    uint16_t message_count = 0;
-    std::chrono::steady_clock::time_point last_read = std::chrono::steady_clock::now();
-    while (true)
+    std::weak_ptr<DataReader> self = self_;
+    Executor::instance().post([self]()
     {
-        std::unique_lock<std::mutex> lock(mtx_);
-        if (running_cond_ && (message_count < delivery_control.max_samples()))
+        if (std::shared_ptr<DataReader> reader = self.lock())
+        {
+            reader->deliver_task();
+        }
+    });
+}
+
+void DataReader::deliver_task()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    retry_timer_ = 0;
+    while (running_cond_ && (message_count_ < delivery_control_.max_samples()))
+    {
+        notified_ = false;
+        uint32_t read_id = read_id_;
+        std::function<bool (const ReadCallbackArgs&, std::vector<dds::xrce::Sample>&)> read_cb = read_cb_;
+        ReadCallbackArgs cb_args = cb_args_;
+        std::shared_ptr<const ContentFilter> content_filter = content_filter_;
+        std::chrono::milliseconds pace_period(delivery_control_.min_pace_period());
+        size_t max_samples = delivery_control_.max_samples() - message_count_;
+        if (!is_batch_format(cb_args.data_format))
+        {
+            max_samples = 1;
+        }
+        else if (dds::xrce::FORMAT_PACKED_SAMPLES == cb_args.data_format)
+        {
+            /* Deltas are relative to the first sample and have to fit in an octet. */
+            max_samples = std::min(max_samples, size_t(UINT8_MAX) + 1);
+        }
+        lock.unlock();
+        refilterHeldSamples(content_filter);
+
+        std::vector<dds::xrce::Sample> samples;
+        std::vector<fastrtps::rtps::InstanceHandle_t> handles;
+        size_t pending_size = 0;
+        std::chrono::milliseconds pace_wait(0);
+        uint32_t batch_read_id = read_id;
+        if (!pending_batch_.empty())
         {
-            if (rtps_subscriber_->getUnreadCount() != 0)
+            /* A batch refused by the output stream goes first, as it was built. */
+            samples.swap(pending_batch_);
+            handles.swap(pending_handles_);
+            cb_args = pending_args_;
+            batch_read_id = pending_read_id_;
+            max_samples = 0;
+        }
+        else if (0 != pace_period.count())
+        {
+            /* Paced reads deliver the most recent sample once per period. */
+            auto now = std::chrono::steady_clock::now();
+            if (now < next_pace_time_)
             {
-                lock.unlock();
-                /* Read operation. */
-                size_t next_data_size = nextDataSize();
-                if (next_data_size != 0u && rate_manager.get_tokens(next_data_size))
+                if (has_paced_sample_ || (0 != getUnreadCount()))
                 {
-                    std::vector<unsigned char> buffer;
-                    if (takeNextData(&buffer))
-                    {
-                        last_read = std::chrono::steady_clock::now();
-                        read_cb(cb_args, buffer);
-                        ++message_count;
-                    }
+                    pace_wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_pace_time_ - now)
+                                + std::chrono::milliseconds(1);
                 }
             }
-            else
+            else if (size_t next_data_size = takeLatestSample(content_filter.get()))
             {
-                /* Wait for new message or terminate signal. */
-                cond_var_.wait(lock);
+                lock.lock();
+                bool tokens = (read_id == read_id_) && rate_manager_.get_tokens(next_data_size);
                 lock.unlock();
+                if (tokens)
+                {
+                    fillSampleInfo(paced_sample_);
+                    samples.push_back(std::move(paced_sample_));
+                    handles.emplace_back();
+                    has_paced_sample_ = false;
+                    next_pace_time_ = now + pace_period;
+                }
+                else
+                {
+                    pending_size = next_data_size;
+                }
             }
+            max_samples = 0;
         }
-        else
+
+        /* Gather as many samples as fit in one DATA submessage. */
+        size_t batch_size = batch_initial_size(cb_args.data_format);
+        while (samples.size() < max_samples)
         {
-            running_cond_ = false;
+            /* Conflated samples are older than the ones left in the history. */
+            bool conflated = !conflated_samples_.empty();
+            size_t next_data_size = conflated
+                    ? conflated_samples_.front().sample.data().serialized_data().size()
+                    : nextDataSize(content_filter.get());
+            if (0 == next_data_size)
+            {
+                break;
+            }
+
+            size_t next_batch_size = batch_next_size(cb_args.data_format, batch_size, next_data_size);
+            if (!samples.empty() && (next_batch_size > cb_args.max_batch_size))
+            {
+                break;
+            }
+
+            lock.lock();
+            bool tokens = (read_id == read_id_) && rate_manager_.get_tokens(next_data_size);
             lock.unlock();
-            stop_max_timer();
-            break;
+            if (!tokens)
+            {
+                pending_size = next_data_size;
+                break;
+            }
+
+            dds::xrce::Sample sample;
+            fastrtps::rtps::InstanceHandle_t handle;
+            if (conflated)
+            {
+                sample = std::move(conflated_samples_.front().sample);
+                handle = conflated_samples_.front().handle;
+                conflated_samples_.pop_front();
+                fillSampleInfo(sample);
+            }
+            else if (!takeNextSample(sample, handle))
+            {
+                break;
+            }
+            samples.push_back(std::move(sample));
+            handles.push_back(handle);
+            batch_size = next_batch_size;
+        }
+
+        if ((0 != pending_size) && cb_args.keep_latest && (0 == pace_period.count()))
+        {
+            /* Keep only the newest sample of each instance while waiting for the bucket.
+               Paced reads already hold the latest sample only. */
+            conflateSamples(content_filter.get());
+        }
+
+        size_t delivered = samples.size();
+        bool accepted = (0 == delivered) || read_cb(cb_args, samples);
+        if (!accepted)
+        {
+            pending_batch_.swap(samples);
+            pending_handles_.swap(handles);
+            pending_args_ = cb_args;
+            pending_read_id_ = batch_read_id;
+        }
+
+        lock.lock();
+        if (!accepted)
+        {
+            if (notified_)
+            {
+                /* The window may have been freed meanwhile. */
+                continue;
+            }
+            window_full_ = true;
+            delivering_ = false;
+            return;
+        }
+
+        if (batch_read_id == read_id_)
+        {
+            message_count_ = uint16_t(message_count_ + delivered);
+        }
+
+        if (((0 != pending_size) || (0 != pace_wait.count())) && running_cond_ && (read_id == read_id_))
+        {
+            /* Resume once the bucket has been refilled or the pace period has elapsed. */
+            std::weak_ptr<DataReader> self = self_;
+            retry_timer_ = Executor::instance().schedule(
+                        (0 != pending_size) ? rate_manager_.time_to_tokens(pending_size) : pace_wait,
+                        [self]()
+                        {
+                            if (std::shared_ptr<DataReader> reader = self.lock())
+                            {
+                                reader->deliver_task();
+                            }
+                        });
+            return;
+        }
+
+        if ((0 == delivered) && (0 == pending_size) && !notified_)
+        {
+            /* Wait for new data or a new read. */
+            delivering_ = false;
+            return;
         }
     }
+
+    if (running_cond_)
+    {
+        /* All the requested samples have been delivered. */
+        stop_read();
+    }
+    delivering_ = false;
 }
 
-void DataReader::on_max_timeout(const asio::error_code& error)
+void DataReader::on_max_timeout(uint32_t read_id)
 {
-    if (!error)
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (read_id == read_id_)
     {
-        std::lock_guard<std::mutex> lock(mtx_);
-        running_cond_ = false;
-        cond_var_.notify_one();
+        max_timer_ = 0;
+        stop_read();
+    }
+}
+
+void DataReader::on_output_window()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    window_full_ = false;
+    if (delivering_)
+    {
+        notified_ = true;
+    }
+    else
+    {
+        delivering_ = true;
+        post_delivery();
     }
 }
 
 void DataReader::onNewDataMessage(eprosima::fastrtps::Subscriber* /*sub*/)
 {
     std::lock_guard<std::mutex> lock(mtx_);
-    cond_var_.notify_one();
+    if (running_cond_ && !window_full_)
+    {
+        if (delivering_)
+        {
+            notified_ = true;
+        }
+        else
+        {
+            delivering_ = true;
+            post_delivery();
+        }
+    }
+    else if (running_cond_ && !delivering_ && cb_args_.keep_latest && (0 == delivery_control_.min_pace_period()))
+    {
+        /* Paused on a full window: no delivery task touches the held samples meanwhile. */
+        conflateSamples(content_filter_.get());
+        conflatePendingBatch();
+    }
 }
 
 bool DataReader::matched(const dds::xrce::ObjectVariant& new_object_rep) const
@@ -277,7 +615,9 @@ bool DataReader::matched(const dds::xrce::ObjectVariant& new_object_rep) const
     }
 
     bool parser_cond = false;
-    const fastrtps::SubscriberAttributes& old_attributes = rtps_subscriber_->getAttributes();
+    const fastrtps::SubscriberAttributes& old_attributes = binding_
+            ? shared_reader_->get_attributes()
+            : rtps_subscriber_->getAttributes();
     fastrtps::SubscriberAttributes new_attributes;
 
     switch (new_object_rep.data_reader().representation()._d())
@@ -301,6 +641,12 @@ bool DataReader::matched(const dds::xrce::ObjectVariant& new_object_rep) const
             }
             break;
         }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            /* The topic is named, not described: same bytes, same reader. */
+            return !binary_representation_.empty() &&
+                   (binary_representation_ == new_object_rep.data_reader().representation().binary_representation());
+        }
         default:
             break;
     }
@@ -308,49 +654,178 @@ bool DataReader::matched(const dds::xrce::ObjectVariant& new_object_rep) const
     return parser_cond && (new_attributes == old_attributes);
 }
 
-ReadTimeEvent::ReadTimeEvent()
-    : m_timer_max(m_io_service_max)
+bool DataReader::takeNextSample(dds::xrce::Sample& sample, fastrtps::rtps::InstanceHandle_t& handle)
 {
+    if (!hasSampleSource())
+    {
+        return false;
+    }
+    fastrtps::SampleInfo_t info;
+    if (!takeNextData(sample.data().serialized_data(), info))
+    {
+        return false;
+    }
+
+    handle = info.iHandle;
+    fillSampleInfo(sample);
+    return true;
 }
 
-int ReadTimeEvent::init_max_timer(int milliseconds)
+size_t DataReader::takeLatestSample(const ContentFilter* content_filter)
 {
-    m_io_service_max.reset();
-    m_timer_max.expires_from_now(std::chrono::milliseconds(milliseconds));
-    m_timer_max.async_wait(std::bind(&ReadTimeEvent::on_max_timeout, this, std::placeholders::_1));
-    return 0;
+    /* Samples conflated by a previous read are older than the ones left in the history. */
+    std::vector<unsigned char>& latest = paced_sample_.data().serialized_data();
+    if (!conflated_samples_.empty())
+    {
+        /* A newer sample takes the slot of its instance: the newest is the last to arrive, not the last slot. */
+        auto newest = conflated_samples_.begin();
+        for (auto it = conflated_samples_.begin(); it != conflated_samples_.end(); ++it)
+        {
+            newest = (newest->arrival <= it->arrival) ? it : newest;
+        }
+        latest.swap(newest->sample.data().serialized_data());
+        conflated_samples_.clear();
+        has_paced_sample_ = true;
+    }
+
+    if (!hasSampleSource())
+    {
+        return has_paced_sample_ ? latest.size() : 0;
+    }
+
+    /* Take everything and keep the newest sample, so stale ones are only copied once out of the history. */
+    std::vector<unsigned char> buffer;
+    fastrtps::SampleInfo_t info;
+    while (takeNextData(buffer, info))
+    {
+        if ((info.sampleKind == rtps::ALIVE) &&
+            ((nullptr == content_filter) || content_filter->evaluate(buffer.data(), buffer.size())))
+        {
+            latest.swap(buffer);
+            has_paced_sample_ = true;
+        }
+    }
+    return has_paced_sample_ ? latest.size() : 0;
 }
 
-void ReadTimeEvent::stop_max_timer()
+void DataReader::conflateSamples(const ContentFilter* content_filter)
 {
-    m_timer_max.cancel();
-    m_io_service_max.stop();
+    if (!hasSampleSource())
+    {
+        return;
+    }
+
+    std::vector<unsigned char> buffer;
+    fastrtps::SampleInfo_t info;
+    while (takeNextData(buffer, info))
+    {
+        if ((info.sampleKind != rtps::ALIVE) ||
+            ((nullptr != content_filter) && !content_filter->evaluate(buffer.data(), buffer.size())))
+        {
+            continue;
+        }
+
+        auto it = std::find_if(conflated_samples_.begin(), conflated_samples_.end(),
+                               [&](const ConflatedSample& conflated)
+                               {
+                                   return std::equal(std::begin(info.iHandle.value), std::end(info.iHandle.value),
+                                                     std::begin(conflated.handle.value));
+                               });
+        if (conflated_samples_.end() != it)
+        {
+            /* The newer sample takes the place of the one it replaces. */
+            it->sample.data().serialized_data().swap(buffer);
+            it->arrival = ++conflated_arrivals_;
+            ++conflated_count_;
+        }
+        else
+        {
+            conflated_samples_.emplace_back();
+            conflated_samples_.back().handle = info.iHandle;
+            conflated_samples_.back().sample.data().serialized_data().swap(buffer);
+            conflated_samples_.back().arrival = ++conflated_arrivals_;
+        }
+    }
 }
 
-void ReadTimeEvent::run_max_timer(int milliseconds)
+void DataReader::conflatePendingBatch()
 {
-    init_max_timer(milliseconds);
-    m_io_service_max.run();
+    /* The refused batch is older than the samples conflated since: those supersede its samples
+       of the same instance, and the rest go first as the oldest arrivals. Its samples are charged again
+       when re-gathered. */
+    size_t charged = 0;
+    for (size_t i = pending_batch_.size(); 0 < i--;)
+    {
+        charged += pending_batch_[i].data().serialized_data().size();
+        const fastrtps::rtps::InstanceHandle_t& handle = pending_handles_[i];
+        auto it = std::find_if(conflated_samples_.begin(), conflated_samples_.end(),
+                               [&](const ConflatedSample& conflated)
+                               {
+                                   return std::equal(std::begin(handle.value), std::end(handle.value),
+                                                     std::begin(conflated.handle.value));
+                               });
+        if (conflated_samples_.end() != it)
+        {
+            ++conflated_count_;
+        }
+        else
+        {
+            conflated_samples_.emplace_front();
+            conflated_samples_.front().handle = handle;
+            conflated_samples_.front().sample = std::move(pending_batch_[i]);
+            conflated_samples_.front().arrival = 0;
+        }
+    }
+    pending_batch_.clear();
+    pending_handles_.clear();
+    rate_manager_.refund_tokens(charged);
 }
 
-bool DataReader::takeNextData(void* data)
+void DataReader::refilterHeldSamples(const std::shared_ptr<const ContentFilter>& content_filter)
 {
-    if (nullptr == rtps_subscriber_)
+    /* Held samples passed the filter of the read they were taken for. */
+    if ((held_filter_ == content_filter) || !content_filter)
     {
-        return false;
+        held_filter_ = content_filter;
+        return;
     }
-    fastrtps::SampleInfo_t info;
-    return rtps_subscriber_->takeNextData(data, &info);
+    held_filter_ = content_filter;
+
+    auto rejected = [&](const dds::xrce::Sample& sample)
+    {
+        const std::vector<unsigned char>& data = sample.data().serialized_data();
+        return !content_filter->evaluate(data.data(), data.size());
+    };
+    if (has_paced_sample_ && rejected(paced_sample_))
+    {
+        has_paced_sample_ = false;
+    }
+    conflated_samples_.erase(std::remove_if(conflated_samples_.begin(), conflated_samples_.end(),
+                                            [&](const ConflatedSample& conflated)
+                                            {
+                                                return rejected(conflated.sample);
+                                            }),
+                             conflated_samples_.end());
+}
+
+void DataReader::fillSampleInfo(dds::xrce::Sample& sample)
+{
+    auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - creation_time_);
+    sample.info().state(dds::xrce::SampleInfoFlags(0));
+    sample.info().sequence_number(sample_seq_++);
+    sample.info().session_time_offset(uint32_t(offset.count()));
 }
 
-size_t DataReader::nextDataSize()
+size_t DataReader::nextDataSize(const ContentFilter* content_filter)
 {
     std::vector<unsigned char> buffer;
     fastrtps::SampleInfo_t info;
     // TODO (Borja): review KEE_PALL configuration.
-    if (rtps_subscriber_->readNextData(&buffer, &info))
+    while (readNextData(buffer, info))
     {
-        if (info_.sampleKind == rtps::ALIVE)
+        if ((info.sampleKind == rtps::ALIVE) &&
+            ((nullptr == content_filter) || content_filter->evaluate(buffer.data(), buffer.size())))
         {
             if (!msg_)
             {
@@ -358,10 +833,31 @@ size_t DataReader::nextDataSize()
             }
             return buffer.size();
         }
+
+        /*
+         * Drop non-alive and filtered out samples so they do not block the ones behind them,
+         * neither consuming tokens nor room in the DATA submessage.
+         */
+        takeNextData(buffer, info);
     }
     return 0;
 }
 
+bool DataReader::takeNextData(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info)
+{
+    return binding_ ? binding_->take_next(data, info) : rtps_subscriber_->takeNextData(&data, &info);
+}
+
+bool DataReader::readNextData(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info)
+{
+    return binding_ ? binding_->read_next(data, info) : rtps_subscriber_->readNextData(&data, &info);
+}
+
+uint64_t DataReader::getUnreadCount()
+{
+    return binding_ ? binding_->unread_count() : rtps_subscriber_->getUnreadCount();
+}
+
 void DataReader::onSubscriptionMatched(fastrtps::Subscriber* /*sub*/, fastrtps::rtps::MatchingInfo& info)
 {
     if (info.status == rtps::MATCHED_MATCHING)
@@ -0,0 +1,307 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/datareader/SharedReader.hpp>
+#include <uxr/agent/topic/TopicBus.hpp>
+#include <uxr/agent/config.hpp>
+#include <fastrtps/Domain.h>
+#include <fastrtps/participant/Participant.h>
+#include <fastrtps/subscriber/Subscriber.h>
+#include <algorithm>
+#include <map>
+
+namespace eprosima {
+namespace uxr {
+
+namespace {
+
+std::mutex registry_mtx;
+std::multimap<fastrtps::Participant*, std::weak_ptr<SharedReader>> registry;
+
+/*
+ * Appends a sample as an RTPS history would: KEEP_LAST keeps depth samples of each instance,
+ * and max_samples bounds them all.
+ */
+void push_bounded(std::deque<SharedReader::Sample>& samples,
+                  const SharedReader::Sample& sample,
+                  size_t depth,
+                  size_t max_samples)
+{
+    if (0 != depth)
+    {
+        const fastrtps::rtps::InstanceHandle_t& handle = sample.info.iHandle;
+        size_t count = 0;
+        auto oldest = samples.end();
+        for (auto it = samples.begin(); it != samples.end(); ++it)
+        {
+            if (std::equal(std::begin(handle.value), std::end(handle.value), std::begin(it->info.iHandle.value)))
+            {
+                oldest = (0 == count) ? it : oldest;
+                ++count;
+            }
+        }
+        if (depth <= count)
+        {
+            samples.erase(oldest);
+        }
+    }
+    if ((0 != max_samples) && (max_samples <= samples.size()))
+    {
+        samples.pop_front();
+    }
+    samples.push_back(sample);
+}
+
+} // unnamed namespace
+
+/**************************************************************************************************
+ * Binding.
+ **************************************************************************************************/
+bool SharedReader::Binding::read_next(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    bool rv = !samples_.empty();
+    if (rv)
+    {
+        data = *samples_.front().data;
+        info = samples_.front().info;
+    }
+    return rv;
+}
+
+bool SharedReader::Binding::take_next(std::vector<unsigned char>& data, fastrtps::SampleInfo_t& info)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    bool rv = !samples_.empty();
+    if (rv)
+    {
+        data = *samples_.front().data;
+        info = samples_.front().info;
+        samples_.pop_front();
+    }
+    return rv;
+}
+
+uint64_t SharedReader::Binding::unread_count()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return samples_.size();
+}
+
+void SharedReader::Binding::push(const Sample& sample)
+{
+    /* Same depth as a history of its own. */
+    std::lock_guard<std::mutex> lock(mtx_);
+    push_bounded(samples_, sample, depth_, max_samples_);
+}
+
+/**************************************************************************************************
+ * SharedReader.
+ **************************************************************************************************/
+SharedReader::SharedReader(const fastrtps::SubscriberAttributes& attributes)
+    : attributes_(attributes),
+      rtps_subscriber_(nullptr),
+      depth_(0),
+      max_samples_(0),
+      durable_(fastrtps::VOLATILE_DURABILITY_QOS != attributes.qos.m_durability.kind),
+      matched_(0)
+{
+    /* The depth counts per instance, the resource limits for the whole history. */
+    int32_t depth = attributes.topic.historyQos.depth;
+    int32_t max_samples = attributes.topic.resourceLimitsQos.max_samples;
+    depth_ = ((fastrtps::KEEP_LAST_HISTORY_QOS == attributes.topic.historyQos.kind) && (0 < depth)) ? size_t(depth) : 0;
+    max_samples_ = (0 < max_samples) ? size_t(max_samples) : 0;
+}
+
+SharedReader::~SharedReader()
+{
+    if (nullptr != rtps_subscriber_)
+    {
+        fastrtps::Domain::removeSubscriber(rtps_subscriber_);
+    }
+}
+
+std::shared_ptr<SharedReader> SharedReader::acquire(fastrtps::Participant* participant,
+                                                    const fastrtps::SubscriberAttributes& attributes)
+{
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    auto range = registry.equal_range(participant);
+    for (auto it = range.first; it != range.second;)
+    {
+        std::shared_ptr<SharedReader> shared_reader = it->second.lock();
+        if (!shared_reader)
+        {
+            it = registry.erase(it);
+            continue;
+        }
+        if (shared_reader->attributes_ == attributes)
+        {
+            return shared_reader;
+        }
+        ++it;
+    }
+
+    std::shared_ptr<SharedReader> shared_reader(new SharedReader(attributes));
+    fastrtps::SubscriberAttributes rtps_attributes = attributes;
+    shared_reader->rtps_subscriber_ = fastrtps::Domain::createSubscriber(participant, rtps_attributes, shared_reader.get());
+    if (nullptr == shared_reader->rtps_subscriber_)
+    {
+        return nullptr;
+    }
+    registry.emplace(participant, shared_reader);
+    if (TOPIC_BUS)
+    {
+        TopicBus::Key key{participant->getAttributes().rtps.builtin.domainId,
+                          attributes.topic.getTopicName(),
+                          attributes.topic.getTopicDataType()};
+        TopicBus::instance().subscribe(key, shared_reader);
+    }
+    return shared_reader;
+}
+
+std::shared_ptr<SharedReader::Binding> SharedReader::bind(std::function<void ()>&& on_data,
+                                                          std::function<void (int)>&& on_matched)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::shared_ptr<Binding> binding = std::make_shared<Binding>(depth_, max_samples_,
+                                                                std::move(on_data), std::move(on_matched));
+    for (const auto& sample : history_)
+    {
+        binding->push(sample);
+    }
+    if (0 != matched_)
+    {
+        binding->on_matched_(matched_);
+    }
+    bindings_.push_back(binding);
+    return binding;
+}
+
+void SharedReader::unbind(const std::shared_ptr<Binding>& binding)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    bindings_.erase(std::remove(bindings_.begin(), bindings_.end(), binding), bindings_.end());
+}
+
+size_t SharedReader::bindings()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return bindings_.size();
+}
+
+bool SharedReader::deliver(const Sample& sample)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    const fastrtps::rtps::GUID_t& writer_guid = sample.info.sample_identity.writer_guid();
+    const fastrtps::rtps::SequenceNumber_t& seq_num = sample.info.sample_identity.sequence_number();
+    if (matched_writers_.end() == matched_writers_.find(writer_guid))
+    {
+        return false;
+    }
+
+    /* The RTPS copy came first. */
+    auto it = from_rtps_.find(writer_guid);
+    if ((from_rtps_.end() != it) && (0 != it->second.erase(seq_num)))
+    {
+        return true;
+    }
+
+    from_bus_[writer_guid].insert(seq_num);
+    push(sample);
+    for (const auto& binding : bindings_)
+    {
+        binding->on_data_();
+    }
+    return true;
+}
+
+void SharedReader::push(const Sample& sample)
+{
+    if (durable_)
+    {
+        push_bounded(history_, sample, depth_, max_samples_);
+    }
+    for (const auto& binding : bindings_)
+    {
+        binding->push(sample);
+    }
+}
+
+void SharedReader::onNewDataMessage(fastrtps::Subscriber* /*sub*/)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    bool received = false;
+    std::vector<unsigned char> buffer;
+    fastrtps::SampleInfo_t info;
+    while (rtps_subscriber_->takeNextData(&buffer, &info))
+    {
+        if (TOPIC_BUS && TopicBus::instance().is_local_writer(info.sample_identity.writer_guid()))
+        {
+            /* Already delivered through the TopicBus. RTPS keeps the order of a writer's samples,
+               so older ones still waiting for their RTPS copy were lost on the way. */
+            const fastrtps::rtps::SequenceNumber_t& seq_num = info.sample_identity.sequence_number();
+            auto it = from_bus_.find(info.sample_identity.writer_guid());
+            if (from_bus_.end() != it)
+            {
+                std::set<fastrtps::rtps::SequenceNumber_t>& seq_nums = it->second;
+                seq_nums.erase(seq_nums.begin(), seq_nums.lower_bound(seq_num));
+                if (0 != seq_nums.erase(seq_num))
+                {
+                    continue;
+                }
+            }
+
+            /* Not through the bus yet, or never will be: the history sent to a late joiner. */
+            from_rtps_[info.sample_identity.writer_guid()].insert(seq_num);
+        }
+
+        /* One copy out of the RTPS history, whatever the number of bindings. */
+        Sample sample{std::make_shared<const std::vector<unsigned char>>(std::move(buffer)), info};
+        buffer = std::vector<unsigned char>();
+        push(sample);
+        received = true;
+    }
+
+    if (received)
+    {
+        for (const auto& binding : bindings_)
+        {
+            binding->on_data_();
+        }
+    }
+}
+
+void SharedReader::onSubscriptionMatched(fastrtps::Subscriber* /*sub*/, fastrtps::rtps::MatchingInfo& info)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    int delta = (info.status == fastrtps::rtps::MATCHED_MATCHING) ? 1 : -1;
+    matched_ += delta;
+    if (0 < delta)
+    {
+        matched_writers_.insert(info.remoteEndpointGuid);
+    }
+    else
+    {
+        matched_writers_.erase(info.remoteEndpointGuid);
+        from_bus_.erase(info.remoteEndpointGuid);
+        from_rtps_.erase(info.remoteEndpointGuid);
+    }
+    for (const auto& binding : bindings_)
+    {
+        binding->on_matched_(delta);
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
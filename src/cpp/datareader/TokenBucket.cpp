@@ -15,88 +15,128 @@
 #include <uxr/agent/utils/TokenBucket.hpp>
 
 #include <algorithm>
-#include <iostream>
 
 using eprosima::uxr::utils::TokenBucket;
 
-TokenBucket::TokenBucket(size_t rate, size_t burst)
+TokenBucket::TokenBucket(size_t rate, size_t burst, std::shared_ptr<TokenBucket> parent)
     : capacity_(burst),
-      rate_(rate)
+      rate_(rate),
+      tolerance_(0),
+      tat_(0),
+      parent_(std::move(parent))
 {
-    // Adjust to min rate
+    // Default rate
     if (rate_ == 0)
     {
-        rate_ = min_rate_;
+        rate_ = default_rate_;
     }
 
-    // Adjust capacity to rate
-    if (rate_ > capacity_)
+    // Without burst, the bucket holds one second
+    if (capacity_ == 0)
     {
         capacity_ = rate_;
     }
 
-    // Adjust capacity to min rate if we use any kind of burst
-    if ((burst != 0) && (capacity_ < min_rate_))
-    {
-        capacity_ = min_rate_;
-    }
-
-    tokens_    = std::min(capacity_, rate_);
-    timestamp_ = std::chrono::steady_clock::now();
+    // The bucket starts with min(capacity, rate) tokens.
+    tolerance_ = emission_time(capacity_);
+    tat_ = now() + tolerance_ - emission_time(std::min(capacity_, rate_));
 }
 
 TokenBucket::TokenBucket::TokenBucket(const TokenBucket& other)
     : capacity_(other.capacity_),
-      tokens_(other.tokens_),
       rate_(other.rate_),
-      timestamp_(other.timestamp_)
+      tolerance_(other.tolerance_),
+      tat_(other.tat_.load()),
+      parent_(other.parent_)
 {
 }
 
 TokenBucket::TokenBucket(TokenBucket&& other) noexcept
     : capacity_(other.capacity_),
-      tokens_(other.tokens_),
       rate_(other.rate_),
-      timestamp_(other.timestamp_)
+      tolerance_(other.tolerance_),
+      tat_(other.tat_.load()),
+      parent_(std::move(other.parent_))
 {
 }
 
 TokenBucket& TokenBucket::operator=(const TokenBucket& other)
 {
     capacity_  = other.capacity_;
-    tokens_    = other.tokens_;
     rate_      = other.rate_;
-    timestamp_ = other.timestamp_;
+    tolerance_ = other.tolerance_;
+    tat_       = other.tat_.load();
+    parent_    = other.parent_;
     return *this;
 }
 
 TokenBucket& TokenBucket::TokenBucket::operator=(TokenBucket&& other) noexcept
 {
     capacity_  = other.capacity_;
-    tokens_    = other.tokens_;
     rate_      = other.rate_;
-    timestamp_ = other.timestamp_;
+    tolerance_ = other.tolerance_;
+    tat_       = other.tat_.load();
+    parent_    = std::move(other.parent_);
     return *this;
 }
 
 bool TokenBucket::get_tokens(size_t tokens)
 {
-    std::lock_guard<std::mutex> lock(data_mutex_);
-    if (tokens <= available_tokens())
+    int64_t increment = emission_time(tokens);
+    int64_t current = now();
+    int64_t tat = tat_.load(std::memory_order_relaxed);
+    int64_t next_tat;
+    do
     {
-        tokens_ = available_tokens() - tokens;
-        timestamp_ = std::chrono::steady_clock::now();
+        next_tat = std::max(tat, current) + increment;
+        bool oversized_on_full = (tokens > capacity_) && (tat <= current);
+        if ((next_tat - current > tolerance_) && !oversized_on_full)
+        {
+            return false;
+        }
     }
-    else
+    while (!tat_.compare_exchange_weak(tat, next_tat, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    // Tokens taken from a bucket are given back when an ancestor cannot grant them.
+    if (parent_ && !parent_->get_tokens(tokens))
     {
+        tat_.fetch_sub(increment, std::memory_order_acq_rel);
         return false;
     }
     return true;
 }
 
-size_t TokenBucket::available_tokens()
+std::chrono::milliseconds TokenBucket::time_to_tokens(size_t tokens)
+{
+    int64_t current = now();
+    int64_t tat = tat_.load(std::memory_order_relaxed);
+    int64_t wait = std::max(tat, current) + emission_time(std::min(tokens, capacity_)) - current - tolerance_;
+    std::chrono::milliseconds rv((wait <= 0) ? 0 : std::max(int64_t(1), (wait + 999999) / 1000000));
+    if (parent_)
+    {
+        rv = std::max(rv, parent_->time_to_tokens(tokens));
+    }
+    return rv;
+}
+
+void TokenBucket::refund_tokens(size_t tokens)
+{
+    tat_.fetch_sub(emission_time(tokens), std::memory_order_acq_rel);
+    if (parent_)
+    {
+        parent_->refund_tokens(tokens);
+    }
+}
+
+int64_t TokenBucket::emission_time(size_t tokens) const
+{
+    // Split to avoid overflowing on large requests.
+    const int64_t nanos = 1000000000;
+    return int64_t(tokens / rate_) * nanos + int64_t(tokens % rate_) * nanos / int64_t(rate_);
+}
+
+int64_t TokenBucket::now()
 {
-    auto now = std::chrono::steady_clock::now();
-    auto delta_sec = std::chrono::duration_cast<std::chrono::milliseconds>(now - timestamp_).count();
-    return std::min(capacity_, tokens_ + (size_t)((rate_ * delta_sec) / 1000));
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
 }
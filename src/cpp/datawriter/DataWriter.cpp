@@ -16,10 +16,14 @@
 #include <uxr/agent/publisher/Publisher.hpp>
 #include <uxr/agent/participant/Participant.hpp>
 #include <uxr/agent/topic/Topic.hpp>
+#include <uxr/agent/config.hpp>
 #include <fastrtps/Domain.h>
+#include <fastrtps/participant/Participant.h>
 #include <fastrtps/publisher/Publisher.h>
+#include <fastrtps/rtps/common/WriteParams.h>
 #include <fastrtps/xmlparser/XMLProfileManager.h>
 #include "../xmlobjects/xmlobjects.h"
+#include "../binobjects/binobjects.h"
 
 #define DEFAULT_XRCE_PARTICIPANT_PROFILE "default_xrce_participant_profile"
 #define DEFAULT_XRCE_PUBLISHER_PROFILE "default_xrce_publisher_profile"
@@ -33,19 +37,25 @@ DataWriter::DataWriter(const dds::xrce::ObjectId& object_id,
     : XRCEObject{object_id},
       publisher_(publisher),
       rtps_publisher_(nullptr),
+      on_bus_(false),
       rtps_publisher_prof_(profile_name),
-      topic_type_(false)
-
+      topic_type_(false),
+      write_stats_{0, 0, 0}
 {
     publisher_->tie_object(object_id);
 }
 
 DataWriter::~DataWriter()
 {
+    if (on_bus_)
+    {
+        TopicBus::instance().remove_writer(get_rtps_publisher()->getGuid());
+    }
     if (nullptr != rtps_publisher_)
     {
         fastrtps::Domain::removePublisher(rtps_publisher_);
     }
+    shared_writer_.reset();
     publisher_->untie_object(get_id());
     if (topic_)
     {
@@ -55,56 +65,37 @@ DataWriter::~DataWriter()
 
 bool DataWriter::init(const dds::xrce::DATAWRITER_Representation& representation, const ObjectContainer& root_objects)
 {
-    bool rv = false;
-    fastrtps::Participant* rtps_participant = publisher_->get_participant()->get_rtps_participant();
-    dds::xrce::ObjectId topic_id;
+    bool parsed = false;
+    fastrtps::PublisherAttributes attributes;
     switch (representation.representation()._d())
     {
         case dds::xrce::REPRESENTATION_BY_REFERENCE:
         {
             const std::string& ref_rep = representation.representation().object_reference();
-            rtps_publisher_ = fastrtps::Domain::createPublisher(rtps_participant, ref_rep, this);
-            if (nullptr != rtps_publisher_)
-            {
-                const std::string& topic_data_type = rtps_publisher_->getAttributes().topic.getTopicDataType();
-                if (publisher_->get_participant()->check_register_topic(topic_data_type, topic_id))
-                {
-                    topic_ = std::dynamic_pointer_cast<Topic>(root_objects.at(topic_id));
-                    topic_->tie_object(get_id());
-                    rv = true;
-                }
-            }
-            else
-            {
-                if (fastrtps::Domain::removePublisher(rtps_publisher_))
-                {
-                    rtps_publisher_ = nullptr;
-                }
-            }
+            parsed = (fastrtps::xmlparser::XMLP_ret::XML_OK ==
+                      fastrtps::xmlparser::XMLProfileManager::fillPublisherAttributes(ref_rep, attributes));
             break;
         }
         case dds::xrce::REPRESENTATION_AS_XML_STRING:
         {
             const std::string& xml_rep = representation.representation().xml_string_representation();
-            fastrtps::PublisherAttributes attributes;
-            if (xmlobjects::parse_publisher(xml_rep.data(), xml_rep.size(), attributes))
+            parsed = xmlobjects::parse_publisher(xml_rep.data(), xml_rep.size(), attributes);
+            break;
+        }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            const std::vector<uint8_t>& bin_rep = representation.representation().binary_representation();
+            std::string topic_name;
+            if (binobjects::parse_datawriter(bin_rep.data(), bin_rep.size(), topic_name, attributes))
             {
-                rtps_publisher_ = fastrtps::Domain::createPublisher(rtps_participant, attributes, this);
-                if (nullptr != rtps_publisher_)
-                {
-                    if (publisher_->get_participant()->check_register_topic(attributes.topic.getTopicDataType(), topic_id))
-                    {
-                        topic_ = std::dynamic_pointer_cast<Topic>(root_objects.at(topic_id));
-                        topic_->tie_object(get_id());
-                        rv = true;
-                    }
-                }
-                else
+                std::shared_ptr<Topic> topic = Topic::find(root_objects, publisher_->get_participant(), topic_name);
+                if (topic)
                 {
-                    if (fastrtps::Domain::removePublisher(rtps_publisher_))
-                    {
-                        rtps_publisher_ = nullptr;
-                    }
+                    attributes.topic.topicName = topic_name;
+                    attributes.topic.topicDataType = topic->get_type_name();
+                    attributes.topic.topicKind = topic->with_key() ? fastrtps::rtps::WITH_KEY : fastrtps::rtps::NO_KEY;
+                    binary_representation_ = bin_rep;
+                    parsed = true;
                 }
             }
             break;
@@ -112,9 +103,45 @@ bool DataWriter::init(const dds::xrce::DATAWRITER_Representation& representation
         default:
             break;
     }
+
+    bool rv = false;
+    dds::xrce::ObjectId topic_id;
+    if (parsed &&
+        publisher_->get_participant()->check_register_topic(attributes.topic.getTopicDataType(), topic_id) &&
+        createRTPSPublisher(publisher_->get_participant()->get_rtps_participant(), attributes))
+    {
+        topic_ = std::dynamic_pointer_cast<Topic>(root_objects.at(topic_id));
+        topic_->tie_object(get_id());
+        rv = true;
+
+        /* Local readers are on the bus only when they come from SharedReaders. */
+        if (TOPIC_BUS && SHARED_READERS)
+        {
+            fastrtps::Participant* rtps_participant = publisher_->get_participant()->get_rtps_participant();
+            bus_key_ = TopicBus::Key{rtps_participant->getAttributes().rtps.builtin.domainId,
+                                     attributes.topic.getTopicName(),
+                                     attributes.topic.getTopicDataType()};
+            TopicBus::instance().add_writer(get_rtps_publisher()->getGuid());
+            on_bus_ = true;
+        }
+    }
     return rv;
 }
 
+bool DataWriter::createRTPSPublisher(fastrtps::Participant* rtps_participant,
+                                     const fastrtps::PublisherAttributes& attributes)
+{
+    if (!SHARED_WRITERS)
+    {
+        fastrtps::PublisherAttributes rtps_attributes = attributes;
+        rtps_publisher_ = fastrtps::Domain::createPublisher(rtps_participant, rtps_attributes, this);
+        return (nullptr != rtps_publisher_);
+    }
+
+    shared_writer_ = SharedWriter::acquire(rtps_participant, attributes);
+    return bool(shared_writer_);
+}
+
 const dds::xrce::ResultStatus& DataWriter::write(dds::xrce::DataRepresentation& data)
 {
     result_status_.status(dds::xrce::STATUS_OK);
@@ -123,19 +150,59 @@ const dds::xrce::ResultStatus& DataWriter::write(dds::xrce::DataRepresentation&
     switch (data._d())
     {
         case dds::xrce::FORMAT_DATA:
-            if (rtps_publisher_->write(&(data.data().serialized_data())))
+        {
+            const std::vector<uint8_t>& serialized_data = data.data().serialized_data();
+            if (!write(serialized_data.data(), serialized_data.size()))
             {
                 result_status_.status(dds::xrce::STATUS_ERR_DDS_ERROR);
             }
             break;
+        }
         case dds::xrce::FORMAT_SAMPLE:
+        {
+            const std::vector<uint8_t>& serialized_data = data.sample().data().serialized_data();
+            if (!write(serialized_data.data(), serialized_data.size()))
+            {
+                result_status_.status(dds::xrce::STATUS_ERR_DDS_ERROR);
+            }
             break;
+        }
         case dds::xrce::FORMAT_DATA_SEQ:
+        {
+            for (const auto& sample_data : data.data_seq())
+            {
+                const std::vector<uint8_t>& serialized_data = sample_data.serialized_data();
+                if (!write(serialized_data.data(), serialized_data.size()))
+                {
+                    result_status_.status(dds::xrce::STATUS_ERR_DDS_ERROR);
+                }
+            }
             break;
+        }
         case dds::xrce::FORMAT_SAMPLE_SEQ:
+        {
+            for (const auto& sample : data.sample_seq())
+            {
+                const std::vector<uint8_t>& serialized_data = sample.data().serialized_data();
+                if (!write(serialized_data.data(), serialized_data.size()))
+                {
+                    result_status_.status(dds::xrce::STATUS_ERR_DDS_ERROR);
+                }
+            }
             break;
+        }
         case dds::xrce::FORMAT_PACKED_SAMPLES:
+        {
+            for (const auto& sample_delta : data.packed_samples().sample_delta_seq())
+            {
+                const std::vector<uint8_t>& serialized_data = sample_delta.data().serialized_data();
+                if (!write(serialized_data.data(), serialized_data.size()))
+                {
+                    result_status_.status(dds::xrce::STATUS_ERR_DDS_ERROR);
+                }
+            }
             break;
+        }
         default:
             result_status_.status(dds::xrce::STATUS_ERR_INCOMPATIBLE);
             break;
@@ -144,13 +211,47 @@ const dds::xrce::ResultStatus& DataWriter::write(dds::xrce::DataRepresentation&
     return result_status_;
 }
 
-bool DataWriter::write(dds::xrce::WRITE_DATA_Payload_Data& write_data)
+bool DataWriter::write(const uint8_t* data, size_t size)
 {
-    if (nullptr == rtps_publisher_)
+    /* The publisher fills in the identity of the sample, which the local readers use to drop duplicates. */
+    bool rv = false;
+    fastrtps::rtps::WriteParams params;
+    if (shared_writer_)
     {
-        return false;
+        rv = shared_writer_->write(data, size, params);
     }
-    return rtps_publisher_->write(&(write_data.data().serialized_data()));
+    else if (nullptr != rtps_publisher_)
+    {
+        SerializedDataView view{data, size};
+        rv = rtps_publisher_->write(&view, params);
+    }
+    if (rv && on_bus_)
+    {
+        TopicBus::instance().publish(bus_key_, params.sample_identity(), data, size);
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mtx_);
+    if (rv)
+    {
+        ++write_stats_.samples;
+        write_stats_.bytes += size;
+    }
+    else
+    {
+        ++write_stats_.errors;
+    }
+    return rv;
+}
+
+fastrtps::Publisher* DataWriter::get_rtps_publisher() const
+{
+    return shared_writer_ ? shared_writer_->get_rtps_publisher() : rtps_publisher_;
+}
+
+DataWriter::WriteStats DataWriter::get_write_stats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mtx_);
+    return write_stats_;
 }
 
 void DataWriter::onPublicationMatched(fastrtps::Publisher*, fastrtps::rtps::MatchingInfo& info)
@@ -174,7 +275,9 @@ bool DataWriter::matched(const dds::xrce::ObjectVariant& new_object_rep) const
     }
 
     bool parser_cond = false;
-    const fastrtps::PublisherAttributes& old_attributes = rtps_publisher_->getAttributes();
+    const fastrtps::PublisherAttributes& old_attributes = shared_writer_
+            ? shared_writer_->get_attributes()
+            : rtps_publisher_->getAttributes();
     fastrtps::PublisherAttributes new_attributes;
 
     switch (new_object_rep.data_writer().representation()._d())
@@ -198,6 +301,12 @@ bool DataWriter::matched(const dds::xrce::ObjectVariant& new_object_rep) const
             }
             break;
         }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            /* The topic is named, not described: same bytes, same writer. */
+            return !binary_representation_.empty() &&
+                   (binary_representation_ == new_object_rep.data_writer().representation().binary_representation());
+        }
         default:
             break;
     }
@@ -0,0 +1,97 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/datawriter/SharedWriter.hpp>
+#include <uxr/agent/types/TopicPubSubType.hpp>
+#include <fastrtps/Domain.h>
+#include <fastrtps/publisher/Publisher.h>
+#include <iostream>
+#include <map>
+
+namespace eprosima {
+namespace uxr {
+
+namespace {
+
+std::mutex registry_mtx;
+std::multimap<fastrtps::Participant*, std::weak_ptr<SharedWriter>> registry;
+
+} // unnamed namespace
+
+SharedWriter::SharedWriter(const fastrtps::PublisherAttributes& attributes)
+    : attributes_(attributes),
+      rtps_publisher_(nullptr)
+{}
+
+SharedWriter::~SharedWriter()
+{
+    if (nullptr != rtps_publisher_)
+    {
+        fastrtps::Domain::removePublisher(rtps_publisher_);
+    }
+}
+
+std::shared_ptr<SharedWriter> SharedWriter::acquire(fastrtps::Participant* participant,
+                                                    const fastrtps::PublisherAttributes& attributes)
+{
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    auto range = registry.equal_range(participant);
+    for (auto it = range.first; it != range.second;)
+    {
+        std::shared_ptr<SharedWriter> shared_writer = it->second.lock();
+        if (!shared_writer)
+        {
+            it = registry.erase(it);
+            continue;
+        }
+        if (shared_writer->attributes_ == attributes)
+        {
+            return shared_writer;
+        }
+        ++it;
+    }
+
+    std::shared_ptr<SharedWriter> shared_writer(new SharedWriter(attributes));
+    fastrtps::PublisherAttributes rtps_attributes = attributes;
+    shared_writer->rtps_publisher_ = fastrtps::Domain::createPublisher(participant, rtps_attributes, shared_writer.get());
+    if (nullptr == shared_writer->rtps_publisher_)
+    {
+        return nullptr;
+    }
+    registry.emplace(participant, shared_writer);
+    return shared_writer;
+}
+
+bool SharedWriter::write(const uint8_t* data, size_t size, fastrtps::rtps::WriteParams& params)
+{
+    /* Writes of different clients go one at a time into the common history. */
+    std::lock_guard<std::mutex> lock(mtx_);
+    SerializedDataView view{data, size};
+    return rtps_publisher_->write(&view, params);
+}
+
+void SharedWriter::onPublicationMatched(fastrtps::Publisher*, fastrtps::rtps::MatchingInfo& info)
+{
+    if (info.status == fastrtps::rtps::MATCHED_MATCHING)
+    {
+        std::cout << "RTPS Subscriber matched " << info.remoteEndpointGuid << std::endl;
+    }
+    else
+    {
+        std::cout << "RTPS Subscriber unmatched " << info.remoteEndpointGuid << std::endl;
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
@@ -13,10 +13,10 @@
 // limitations under the License.
 
 #include <uxr/agent/participant/Participant.hpp>
-#include <fastrtps/Domain.h>
-#include <fastrtps/participant/Participant.h>
+#include <uxr/agent/participant/ParticipantPool.hpp>
 #include <fastrtps/xmlparser/XMLProfileManager.h>
 #include "../xmlobjects/xmlobjects.h"
+#include "../binobjects/binobjects.h"
 
 #define DEFAULT_XRCE_PARTICIPANT_PROFILE "default_xrce_participant_profile"
 
@@ -29,7 +29,7 @@ Participant::~Participant()
 {
     if (nullptr != rtps_participant_)
     {
-        fastrtps::Domain::removeParticipant(rtps_participant_);
+        ParticipantPool::instance().release(rtps_participant_);
     }
 }
 
@@ -43,8 +43,14 @@ bool Participant::init(const dds::xrce::OBJK_PARTICIPANT_Representation& represe
             if (nullptr == rtps_participant_)
             {
                 const std::string& ref_rep = representation.representation().object_reference();
-                rtps_participant_ = fastrtps::Domain::createParticipant(ref_rep, this);
-                rv = (nullptr != rtps_participant_);
+                fastrtps::ParticipantAttributes attributes;
+                if (fastrtps::xmlparser::XMLP_ret::XML_OK ==
+                    fastrtps::xmlparser::XMLProfileManager::fillParticipantAttributes(ref_rep, attributes))
+                {
+                    rtps_participant_ = ParticipantPool::instance().acquire(attributes);
+                    attributes_ = attributes;
+                    rv = (nullptr != rtps_participant_);
+                }
             }
             break;
         }
@@ -56,7 +62,23 @@ bool Participant::init(const dds::xrce::OBJK_PARTICIPANT_Representation& represe
                 fastrtps::ParticipantAttributes attributes;
                 if (xmlobjects::parse_participant(xml_rep.data(), xml_rep.size(), attributes))
                 {
-                    rtps_participant_ = fastrtps::Domain::createParticipant(attributes, this);
+                    rtps_participant_ = ParticipantPool::instance().acquire(attributes);
+                    attributes_ = attributes;
+                    rv = (nullptr != rtps_participant_);
+                }
+            }
+            break;
+        }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            if (nullptr == rtps_participant_)
+            {
+                const std::vector<uint8_t>& bin_rep = representation.representation().binary_representation();
+                fastrtps::ParticipantAttributes attributes;
+                if (binobjects::parse_participant(bin_rep.data(), bin_rep.size(), representation.domain_id(), attributes))
+                {
+                    rtps_participant_ = ParticipantPool::instance().acquire(attributes);
+                    attributes_ = attributes;
                     rv = (nullptr != rtps_participant_);
                 }
             }
@@ -100,18 +122,6 @@ void Participant::release(ObjectContainer& root_objects)
     }
 }
 
-void Participant::onParticipantDiscovery(eprosima::fastrtps::Participant*, eprosima::fastrtps::ParticipantDiscoveryInfo info)
-{
-    if(info.rtps.m_status == eprosima::fastrtps::rtps::DISCOVERED_RTPSPARTICIPANT)
-    {
-        std::cout << "RTPS Participant matched " << info.rtps.m_guid << std::endl;
-    }
-    else
-    {
-        std::cout << "RTPS Participant unmatched " << info.rtps.m_guid << std::endl;
-    }
-}
-
 bool Participant::matched(const dds::xrce::ObjectVariant& new_object_rep) const
 {
     /* Check ObjectKind. */
@@ -121,7 +131,6 @@ bool Participant::matched(const dds::xrce::ObjectVariant& new_object_rep) const
     }
 
     bool parser_cond = false;
-    const fastrtps::ParticipantAttributes& old_attributes = rtps_participant_->getAttributes();
     fastrtps::ParticipantAttributes new_attributes;
 
     switch (new_object_rep.participant().representation()._d())
@@ -145,11 +154,21 @@ bool Participant::matched(const dds::xrce::ObjectVariant& new_object_rep) const
             }
             break;
         }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            const std::vector<uint8_t>& bin_rep = new_object_rep.participant().representation().binary_representation();
+            if (binobjects::parse_participant(bin_rep.data(), bin_rep.size(),
+                                              new_object_rep.participant().domain_id(), new_attributes))
+            {
+                parser_cond = true;
+            }
+            break;
+        }
         default:
             break;
     }
 
-    return parser_cond && (new_attributes == old_attributes);
+    return parser_cond && (new_attributes == attributes_);
 }
 
 } // namespace uxr
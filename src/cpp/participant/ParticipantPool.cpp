@@ -0,0 +1,384 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/participant/ParticipantPool.hpp>
+#include <uxr/agent/scheduler/Executor.hpp>
+#include <fastrtps/Domain.h>
+#include <fastrtps/participant/Participant.h>
+#include <fastrtps/xmlparser/XMLProfileManager.h>
+#include <functional>
+#include <iostream>
+
+namespace eprosima {
+namespace uxr {
+
+namespace {
+
+/* The name only labels the participant in discovery, it does not make two configurations differ. */
+fastrtps::ParticipantAttributes normalize(const fastrtps::ParticipantAttributes& attributes)
+{
+    fastrtps::ParticipantAttributes normalized = attributes;
+    normalized.rtps.setName("");
+    return normalized;
+}
+
+} // unnamed namespace
+
+ParticipantPool::ParticipantPool() = default;
+
+ParticipantPool::~ParticipantPool()
+{
+    /* Pending top ups use the pool, the idle participants are left to the Domain. */
+    warmer_.reset();
+}
+
+ParticipantPool& ParticipantPool::instance()
+{
+    static ParticipantPool pool;
+    return pool;
+}
+
+fastrtps::Participant* ParticipantPool::acquire(const fastrtps::ParticipantAttributes& attributes)
+{
+    fastrtps::ParticipantAttributes normalized = normalize(attributes);
+    uint32_t domain_id = normalized.rtps.builtin.domainId;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (fastrtps::Participant* participant = share(normalized))
+        {
+            return participant;
+        }
+
+        for (size_t i = 0; i < warm_.size(); ++i)
+        {
+            Warm& warm = warm_[i];
+            if (!warm.idle.empty() && (warm.normalized == normalized))
+            {
+                fastrtps::Participant* participant = warm.idle.back();
+                warm.idle.pop_back();
+                participants_.emplace(participant, Entry{normalized, 1, {}});
+                domains_.emplace(domain_id, participant);
+                if (warmer_)
+                {
+                    ++warm.pending;
+                    warmer_->post(std::bind(&ParticipantPool::top_up, this, i));
+                }
+                return participant;
+            }
+        }
+    }
+
+    /* Created without the lock, so other clients are not held by the RTPS discovery set up. */
+    fastrtps::ParticipantAttributes rtps_attributes = attributes;
+    fastrtps::Participant* participant = fastrtps::Domain::createParticipant(rtps_attributes, this);
+    if (nullptr == participant)
+    {
+        return nullptr;
+    }
+
+    fastrtps::Participant* shared;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        shared = share(normalized);
+        if (nullptr == shared)
+        {
+            participants_.emplace(participant, Entry{normalized, 1, {}});
+            domains_.emplace(domain_id, participant);
+            return participant;
+        }
+    }
+
+    /* Another client created the same participant meanwhile. */
+    fastrtps::Domain::removeParticipant(participant);
+    return shared;
+}
+
+void ParticipantPool::release(fastrtps::Participant* participant)
+{
+    std::map<std::string, RegisteredType> types;
+    fastrtps::ParticipantAttributes normalized;
+    size_t warm_index;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = participants_.find(participant);
+        if ((participants_.end() == it) || (0 != --it->second.references))
+        {
+            return;
+        }
+
+        auto range = domains_.equal_range(it->second.attributes.rtps.builtin.domainId);
+        for (auto domain_it = range.first; domain_it != range.second; ++domain_it)
+        {
+            if (participant == domain_it->second)
+            {
+                domains_.erase(domain_it);
+                break;
+            }
+        }
+
+        /* Back to the warm pool if it is short of idle participants of this kind. */
+        warm_index = warm_.size();
+        for (size_t i = 0; i < warm_.size(); ++i)
+        {
+            Warm& warm = warm_[i];
+            if ((warm.idle.size() + warm.pending < warm.count) && (warm.normalized == it->second.attributes))
+            {
+                ++warm.pending;
+                warm_index = i;
+                break;
+            }
+        }
+        normalized = it->second.attributes;
+        types.swap(it->second.types);
+        participants_.erase(it);
+    }
+
+    /* Last reference: its endpoints are gone, so are the users of its types. */
+    for (auto& type : types)
+    {
+        fastrtps::Domain::unregisterType(participant, type.first.c_str());
+    }
+
+    bool parked = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        /* The warm pool may have been cleared meanwhile. */
+        if ((warm_index < warm_.size()) && (warm_[warm_index].normalized == normalized))
+        {
+            --warm_[warm_index].pending;
+            warm_[warm_index].idle.push_back(participant);
+            parked = true;
+        }
+    }
+    if (!parked)
+    {
+        fastrtps::Domain::removeParticipant(participant);
+    }
+}
+
+bool ParticipantPool::register_type(fastrtps::Participant* participant, const std::string& type_name, bool with_key)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = participants_.find(participant);
+    if (participants_.end() == it)
+    {
+        return false;
+    }
+
+    bool rv = false;
+    auto type_it = it->second.types.find(type_name);
+    if (it->second.types.end() != type_it)
+    {
+        /* Same name, same keyed-ness: it is the same type. */
+        if (type_it->second.type->m_isGetKeyDefined == with_key)
+        {
+            ++type_it->second.references;
+            rv = true;
+        }
+    }
+    else
+    {
+        std::unique_ptr<TopicPubSubType> type(new TopicPubSubType(with_key));
+        type->setName(type_name.c_str());
+        type->m_isGetKeyDefined = with_key;
+        if (fastrtps::Domain::registerType(participant, type.get()))
+        {
+            it->second.types.emplace(type_name, RegisteredType{std::move(type), 1});
+            rv = true;
+        }
+    }
+    return rv;
+}
+
+void ParticipantPool::unregister_type(fastrtps::Participant* participant, const std::string& type_name)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = participants_.find(participant);
+    if (participants_.end() != it)
+    {
+        auto type_it = it->second.types.find(type_name);
+        if ((it->second.types.end() != type_it) && (0 == --type_it->second.references))
+        {
+            fastrtps::Domain::unregisterType(participant, type_name.c_str());
+            it->second.types.erase(type_it);
+        }
+    }
+}
+
+fastrtps::Participant* ParticipantPool::share(const fastrtps::ParticipantAttributes& normalized)
+{
+    auto range = domains_.equal_range(normalized.rtps.builtin.domainId);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        Entry& entry = participants_.at(it->second);
+        if (entry.attributes == normalized)
+        {
+            ++entry.references;
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+size_t ParticipantPool::size()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return participants_.size();
+}
+
+size_t ParticipantPool::references(fastrtps::Participant* participant)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = participants_.find(participant);
+    return (participants_.end() != it) ? it->second.references : 0;
+}
+
+bool ParticipantPool::prewarm(const std::string& profile, size_t count)
+{
+    fastrtps::ParticipantAttributes attributes;
+    bool rv = (fastrtps::xmlparser::XMLP_ret::XML_OK ==
+               fastrtps::xmlparser::XMLProfileManager::fillParticipantAttributes(profile, attributes));
+    if (rv)
+    {
+        rv = prewarm(attributes, count);
+    }
+    return rv;
+}
+
+bool ParticipantPool::prewarm(uint16_t domain_id, size_t count)
+{
+    fastrtps::ParticipantAttributes attributes;
+    attributes.rtps.builtin.domainId = domain_id;
+    return prewarm(attributes, count);
+}
+
+bool ParticipantPool::prewarm(const fastrtps::ParticipantAttributes& attributes, size_t count)
+{
+    size_t index;
+    size_t missing = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        fastrtps::ParticipantAttributes normalized = normalize(attributes);
+        for (index = 0; index < warm_.size(); ++index)
+        {
+            if (warm_[index].normalized == normalized)
+            {
+                break;
+            }
+        }
+        if (warm_.size() == index)
+        {
+            warm_.push_back(Warm{attributes, normalized, 0, 0, {}});
+        }
+
+        Warm& warm = warm_[index];
+        warm.count = count;
+        if (warm.idle.size() + warm.pending < count)
+        {
+            missing = count - warm.idle.size() - warm.pending;
+            warm.pending += missing;
+        }
+        if (!warmer_)
+        {
+            warmer_.reset(new Executor(1));
+        }
+    }
+
+    /* Startup: created here, so that the first clients already find them. */
+    bool rv = true;
+    for (size_t i = 0; i < missing; ++i)
+    {
+        fastrtps::ParticipantAttributes rtps_attributes = attributes;
+        fastrtps::Participant* participant = fastrtps::Domain::createParticipant(rtps_attributes, this);
+        std::lock_guard<std::mutex> lock(mtx_);
+        --warm_[index].pending;
+        if (nullptr != participant)
+        {
+            warm_[index].idle.push_back(participant);
+        }
+        else
+        {
+            rv = false;
+        }
+    }
+    return rv;
+}
+
+void ParticipantPool::top_up(size_t warm_index)
+{
+    /* warm_ only grows while the warmer runs. */
+    fastrtps::ParticipantAttributes attributes;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        attributes = warm_[warm_index].attributes;
+    }
+
+    fastrtps::Participant* participant = fastrtps::Domain::createParticipant(attributes, this);
+    std::lock_guard<std::mutex> lock(mtx_);
+    Warm& warm = warm_[warm_index];
+    --warm.pending;
+    if (nullptr != participant)
+    {
+        warm.idle.push_back(participant);
+    }
+}
+
+size_t ParticipantPool::warm_size()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    size_t rv = 0;
+    for (const auto& warm : warm_)
+    {
+        rv += warm.idle.size();
+    }
+    return rv;
+}
+
+void ParticipantPool::clear_warm()
+{
+    std::unique_ptr<Executor> warmer;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        warmer = std::move(warmer_);
+    }
+    warmer.reset();
+
+    std::vector<Warm> warm;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        warm.swap(warm_);
+    }
+    for (auto& idle_warm : warm)
+    {
+        for (auto participant : idle_warm.idle)
+        {
+            fastrtps::Domain::removeParticipant(participant);
+        }
+    }
+}
+
+void ParticipantPool::onParticipantDiscovery(fastrtps::Participant*, fastrtps::ParticipantDiscoveryInfo info)
+{
+    if(info.rtps.m_status == fastrtps::rtps::DISCOVERED_RTPSPARTICIPANT)
+    {
+        std::cout << "RTPS Participant matched " << info.rtps.m_guid << std::endl;
+    }
+    else
+    {
+        std::cout << "RTPS Participant unmatched " << info.rtps.m_guid << std::endl;
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
@@ -17,17 +17,23 @@
 #include <uxr/agent/datareader/DataReader.hpp>
 #include <uxr/agent/Root.hpp>
 #include <uxr/agent/transport/Server.hpp>
+#include <uxr/agent/scheduler/Executor.hpp>
+#include <uxr/agent/config.hpp>
 
 namespace eprosima {
 namespace uxr {
 
 Processor::Processor(Server* server)
     : server_(server),
-      root_(new Root())
+      root_(new Root()),
+      creation_executor_((0 != CREATION_THREADS) ? new Executor(CREATION_THREADS) : nullptr),
+      last_creation_(0)
 {}
 
 Processor::~Processor()
 {
+    /* Creations in progress finish before the clients go away. */
+    creation_executor_.reset();
     delete root_;
 }
 
@@ -59,11 +65,11 @@ void Processor::process_input_packet(InputPacket&& input_packet)
             if (session.next_input_message(input_packet.message))
             {
                 /* Process messages. */
-                process_input_message(*client, input_packet);
+                dispatch_input_message(*client, input_packet);
                 client = root_->get_client(client_key);
                 while (nullptr != client && session.pop_input_message(stream_id, input_packet.message))
                 {
-                    process_input_message(*client, input_packet);
+                    dispatch_input_message(*client, input_packet);
                     client = root_->get_client(client_key);
                 }
 
@@ -87,6 +93,7 @@ void Processor::process_input_packet(InputPacket&& input_packet)
                 /* Set output packet and serialize ACKNACK. */
                 OutputPacket output_packet;
                 output_packet.destination = input_packet.source;
+                output_packet.budget = client->budget();
                 output_packet.message.reset(new OutputMessage(acknack_header));
                 output_packet.message->append_submessage(dds::xrce::ACKNACK, acknack_payload);
 
@@ -108,17 +115,38 @@ void Processor::process_input_message(ProxyClient& client, InputPacket& input_pa
     }
 }
 
+/*
+ * Messages on the user streams of a client with a creation in progress wait behind it.
+ * The session ones (stream 0x00) do not, they carry no object operation to order.
+ */
+void Processor::dispatch_input_message(ProxyClient& client, InputPacket& input_packet)
+{
+    if (0x00 != input_packet.message->get_header().stream_id())
+    {
+        std::lock_guard<std::mutex> lock(pending_mtx_);
+        auto it = pending_.find(client.get_client_key());
+        if (pending_.end() != it)
+        {
+            it->second.deferred.push_back(InputPacket{input_packet.source, std::move(input_packet.message)});
+            return;
+        }
+    }
+    process_input_message(client, input_packet);
+}
+
 bool Processor::process_submessage(ProxyClient& client, InputPacket& input_packet)
 {
     bool rv;
     dds::xrce::SubmessageId submessage_id = input_packet.message->get_subheader().submessage_id();
-    std::lock_guard<std::mutex> lock(mtx_);
+    std::unique_lock<std::mutex> lock(mtx_);
     switch (submessage_id)
     {
         case dds::xrce::CREATE_CLIENT:
             rv = process_create_client_submessage(input_packet);
             break;
         case dds::xrce::CREATE:
+            /* Creating may take long, only the STATUS takes the processor lock. */
+            lock.unlock();
             rv = process_create_submessage(client, input_packet);
             break;
         case dds::xrce::GET_INFO:
@@ -132,6 +160,8 @@ bool Processor::process_submessage(ProxyClient& client, InputPacket& input_packe
             rv = process_write_data_submessage(client, input_packet);
             break;
         case dds::xrce::READ_DATA:
+            /* Arming a read never waits for the ongoing delivery, so it is done outside the processor lock. */
+            lock.unlock();
             rv = process_read_data_submessage(client, input_packet);
             break;
         case dds::xrce::ACKNACK:
@@ -183,6 +213,16 @@ bool Processor::process_create_client_submessage(InputPacket& input_packet)
             {
                 server_->on_create_client(input_packet.source.get(),
                                           client_payload.client_representation().client_key());
+
+                /* Acknowledge the FEC group size, clients not seeing it must not expect FEC_PARITY. */
+                std::shared_ptr<ProxyClient> client = root_->get_client(client_payload.client_representation().client_key());
+                if (client && (0 != client->session().fec_group()))
+                {
+                    dds::xrce::Property fec_property;
+                    fec_property.name("uxr_fec_group");
+                    fec_property.value(std::to_string(client->session().fec_group()));
+                    agent_representation.properties(dds::xrce::PropertySeq{fec_property});
+                }
             }
             status_payload.result(result);
             status_payload.agent_info(agent_representation);
@@ -215,36 +255,100 @@ bool Processor::process_create_submessage(ProxyClient& client, InputPacket& inpu
     dds::xrce::CREATE_Payload create_payload;
     if (input_packet.message->get_payload(create_payload))
     {
-        /* STATUS header. */
-        dds::xrce::MessageHeader status_header;
-        status_header.session_id(input_packet.message->get_header().session_id());
-        status_header.stream_id(0x80);
-        status_header.sequence_nr(client.session().next_output_message(0x80));
-        status_header.client_key(input_packet.message->get_header().client_key());
-
-        /* STATUS payload. */
-        dds::xrce::STATUS_Payload status_payload;
-        status_payload.related_request().request_id(create_payload.request_id());
-        status_payload.related_request().object_id(create_payload.object_id());
-        status_payload.result(client.create(creation_mode,
-                                            create_payload.object_id(),
-                                            create_payload.object_representation()));
-
-        /* Set output packet and Serialize STATUS. */
-        OutputPacket output_packet;
-        output_packet.destination = input_packet.source;
-        output_packet.message = OutputMessagePtr(new OutputMessage(status_header));
-        output_packet.message->append_submessage(dds::xrce::STATUS, status_payload);
+        std::shared_ptr<ProxyClient> shared_client = root_->get_client(client.get_client_key());
+        if (!creation_executor_ || !shared_client || (0x00 == input_packet.message->get_header().stream_id()))
+        {
+            complete_create(shared_client, input_packet.source, creation_mode, create_payload);
+        }
+        else
+        {
+            /* The rest of this message goes first among the deferred ones, it comes before them. */
+            uint64_t creation;
+            {
+                std::lock_guard<std::mutex> lock(pending_mtx_);
+                creation = ++last_creation_;
+                PendingCreation& pending = pending_[client.get_client_key()];
+                pending.owner = creation;
+                pending.deferred.push_front(InputPacket{input_packet.source, std::move(input_packet.message)});
+            }
 
-        /* Store message. */
-        client.session().push_output_message(0x80, output_packet.message);
+            std::shared_ptr<EndPoint> source = input_packet.source;
+            creation_executor_->post([this, shared_client, source, creation_mode, create_payload, creation]()
+            {
+                complete_create(shared_client, source, creation_mode, create_payload);
+
+                /*
+                 * Resume the client where it stopped, until it is done or waits for another creation,
+                 * which then takes over the deferred messages.
+                 */
+                std::unique_lock<std::mutex> lock(pending_mtx_);
+                auto it = pending_.find(shared_client->get_client_key());
+                while ((pending_.end() != it) && (creation == it->second.owner))
+                {
+                    if (it->second.deferred.empty())
+                    {
+                        pending_.erase(it);
+                        break;
+                    }
+                    InputPacket deferred_packet = std::move(it->second.deferred.front());
+                    it->second.deferred.pop_front();
+                    lock.unlock();
+                    process_input_message(*shared_client, deferred_packet);
+                    lock.lock();
+                    it = pending_.find(shared_client->get_client_key());
+                }
+            });
 
-        /* Send status. */
-        server_->push_output_packet(output_packet);
+            /* Stop processing this message, its remaining submessages were deferred. */
+            rv = false;
+        }
     }
     return rv;
 }
 
+void Processor::complete_create(const std::shared_ptr<ProxyClient>& client,
+                                const std::shared_ptr<EndPoint>& source,
+                                const dds::xrce::CreationMode& creation_mode,
+                                const dds::xrce::CREATE_Payload& create_payload)
+{
+    if (!client)
+    {
+        return;
+    }
+
+    /* STATUS payload, the creation itself runs outside the processor lock. */
+    dds::xrce::STATUS_Payload status_payload;
+    status_payload.related_request().request_id(create_payload.request_id());
+    status_payload.related_request().object_id(create_payload.object_id());
+    status_payload.result(client->create(creation_mode,
+                                         create_payload.object_id(),
+                                         create_payload.object_representation()));
+
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    /* STATUS header. */
+    dds::xrce::MessageHeader status_header;
+    status_header.session_id(client->get_session_id());
+    status_header.stream_id(0x80);
+    status_header.sequence_nr(client->session().next_output_message(0x80));
+    status_header.client_key(client->get_client_key());
+
+    /* Set output packet and Serialize STATUS. */
+    OutputPacket output_packet;
+    output_packet.destination = source;
+    output_packet.budget = client->budget();
+    output_packet.message = OutputMessagePtr(new OutputMessage(status_header));
+    output_packet.message->append_submessage(dds::xrce::STATUS, status_payload);
+
+    /* Store message. */
+    client->session().push_output_message(0x80, output_packet.message);
+    arm_heartbeat(*client, 0x80);
+
+    /* Send status. */
+    server_->push_output_packet(output_packet);
+    send_fec_parity(*client, 0x80);
+}
+
 bool Processor::process_delete_submessage(ProxyClient& client, InputPacket& input_packet)
 {
     bool rv = true;
@@ -264,6 +368,7 @@ bool Processor::process_delete_submessage(ProxyClient& client, InputPacket& inpu
         /* Serialize STATUS. */
         OutputPacket output_packet;
         output_packet.destination = input_packet.source;
+        output_packet.budget = client.budget();
 
         /* Delete object. */
         if ((delete_payload.object_id().at(1) & 0x0F) == dds::xrce::OBJK_CLIENT)
@@ -276,6 +381,7 @@ bool Processor::process_delete_submessage(ProxyClient& client, InputPacket& inpu
             dds::xrce::ClientKey client_key = server_->get_client_key(input_packet.source.get());
             status_payload.result(root_->delete_client(client_key));
             output_packet.message = OutputMessagePtr(new OutputMessage(status_header));
+            output_packet.message->append_submessage(dds::xrce::STATUS, status_payload, 0);
         }
         else
         {
@@ -288,14 +394,19 @@ bool Processor::process_delete_submessage(ProxyClient& client, InputPacket& inpu
             /* Set result status. */
             status_payload.result(client.delete_object(delete_payload.object_id()));
 
-            /* Store message. */
+            /* Serialize before storing, the FEC parity covers the final content. */
             output_packet.message = OutputMessagePtr(new OutputMessage(status_header));
+            output_packet.message->append_submessage(dds::xrce::STATUS, status_payload, 0);
             client.session().push_output_message(stream_id, output_packet.message);
+            arm_heartbeat(client, stream_id);
         }
-        output_packet.message->append_submessage(dds::xrce::STATUS, status_payload, 0);
 
         /* Send message. */
         server_->push_output_packet(output_packet);
+        if (0x00 != status_header.stream_id())
+        {
+            send_fec_parity(client, status_header.stream_id());
+        }
     }
     else
     {
@@ -310,25 +421,69 @@ bool Processor::process_write_data_submessage(ProxyClient& client, InputPacket&
     bool rv = true;
     bool deserialized = false, written = false;
     uint8_t flags = input_packet.message->get_subheader().flags() & 0x0E;
-    dds::xrce::DataRepresentation data;
-    switch (flags)
+    InputMessage& message = *input_packet.message;
+
+    /* Samples are written straight from the input message buffer, one RTPS write per sample. */
+    dds::xrce::BaseObjectRequest request;
+    if (message.get_payload(request))
     {
-        case dds::xrce::FORMAT_DATA_FLAG: ;
+        DataWriter* data_writer = dynamic_cast<DataWriter*>(client.get_object(request.object_id()));
+        const uint8_t* serialized_data;
+        size_t serialized_size;
+        switch (flags)
         {
-            dds::xrce::WRITE_DATA_Payload_Data data_payload;
-            if (input_packet.message->get_payload(data_payload))
+            case dds::xrce::FORMAT_DATA_FLAG:
             {
-                deserialized = true;
-                DataWriter* data_writer = dynamic_cast<DataWriter*>(client.get_object(data_payload.object_id()));
-                if (nullptr != data_writer)
+                deserialized = message.get_serialized_data(serialized_data, serialized_size);
+                written = deserialized && (nullptr != data_writer) &&
+                          data_writer->write(serialized_data, serialized_size);
+                break;
+            }
+            case dds::xrce::FORMAT_SAMPLE_FLAG:
+            {
+                dds::xrce::SampleInfo sample_info;
+                deserialized = message.get_payload(sample_info) &&
+                               message.get_serialized_data(serialized_data, serialized_size);
+                written = deserialized && (nullptr != data_writer) &&
+                          data_writer->write(serialized_data, serialized_size);
+                break;
+            }
+            case dds::xrce::FORMAT_DATA_SEQ_FLAG:
+            case dds::xrce::FORMAT_SAMPLE_SEQ_FLAG:
+            {
+                uint32_t length;
+                deserialized = message.get_sequence_length(length);
+                written = (nullptr != data_writer);
+                for (uint32_t i = 0; deserialized && written && (i < length); ++i)
                 {
-                    written = data_writer->write(data_payload);
+                    if (dds::xrce::FORMAT_SAMPLE_SEQ_FLAG == flags)
+                    {
+                        dds::xrce::SampleInfo sample_info;
+                        deserialized = message.get_payload(sample_info);
+                    }
+                    deserialized = deserialized && message.get_serialized_data(serialized_data, serialized_size);
+                    written = deserialized && data_writer->write(serialized_data, serialized_size);
                 }
+                break;
             }
-            break;
+            case dds::xrce::FORMAT_PACKED_SAMPLES_FLAG:
+            {
+                dds::xrce::SampleInfo info_base;
+                uint32_t length;
+                deserialized = message.get_payload(info_base) && message.get_sequence_length(length);
+                written = (nullptr != data_writer);
+                for (uint32_t i = 0; deserialized && written && (i < length); ++i)
+                {
+                    dds::xrce::SampleInfoDelta info_delta;
+                    deserialized = message.get_payload(info_delta) &&
+                                   message.get_serialized_data(serialized_data, serialized_size);
+                    written = deserialized && data_writer->write(serialized_data, serialized_size);
+                }
+                break;
+            }
+            default:
+                break;
         }
-        default:
-            break;
     }
 
     if (!deserialized)
@@ -352,6 +507,7 @@ bool Processor::process_read_data_submessage(ProxyClient& client, InputPacket& i
     dds::xrce::READ_DATA_Payload read_payload;
     if (input_packet.message->get_payload(read_payload))
     {
+        dds::xrce::StatusValue status = dds::xrce::STATUS_ERR_UNKNOWN_REFERENCE;
         DataReader* data_reader = dynamic_cast<DataReader*>(client.get_object(read_payload.object_id()));
         if (nullptr != data_reader)
         {
@@ -361,13 +517,20 @@ bool Processor::process_read_data_submessage(ProxyClient& client, InputPacket& i
             cb_args.stream_id = read_payload.read_specification().data_stream_id();
             cb_args.object_id = read_payload.object_id();
             cb_args.request_id = read_payload.request_id();
+            cb_args.max_batch_size = client.session().max_payload_size(cb_args.stream_id);
+            cb_args.keep_latest = client.keep_latest();
 
             /* Launch read data. */
             using namespace std::placeholders;
-            data_reader->read(read_payload, std::bind(&Processor::read_data_callback, this, _1, _2), cb_args);
+            status = data_reader->read(read_payload, std::bind(&Processor::read_data_callback, this, _1, _2), cb_args)
+                    ? dds::xrce::STATUS_OK
+                    : dds::xrce::STATUS_ERR_INVALID_DATA;
         }
-        else
+
+        if (dds::xrce::STATUS_OK != status)
         {
+            std::lock_guard<std::mutex> lock(mtx_);
+
             /* STATUS header. */
             uint8_t stream_id = 0x80;
             dds::xrce::MessageHeader status_header;
@@ -381,19 +544,22 @@ bool Processor::process_read_data_submessage(ProxyClient& client, InputPacket& i
             status_payload.related_request().request_id(read_payload.request_id());
             status_payload.related_request().object_id(read_payload.object_id());
             status_payload.result().implementation_status(0x00);
-            status_payload.result().status(dds::xrce::STATUS_ERR_UNKNOWN_REFERENCE);
+            status_payload.result().status(status);
 
             /* Set output packet and serialize STATUS. */
             OutputPacket output_packet;
             output_packet.destination = input_packet.source;
+            output_packet.budget = client.budget();
             output_packet.message = OutputMessagePtr(new OutputMessage(status_header));
             output_packet.message->append_submessage(dds::xrce::STATUS, status_payload);
 
             /* Store message. */
             client.session().push_output_message(stream_id, output_packet.message);
+            arm_heartbeat(client, stream_id);
 
             /* Send message. */
             server_->push_output_packet(output_packet);
+            send_fec_parity(client, stream_id);
         }
     }
     else
@@ -410,33 +576,45 @@ bool Processor::process_acknack_submessage(ProxyClient& client, InputPacket& inp
     dds::xrce::ACKNACK_Payload acknack_payload;
     if (input_packet.message->get_payload(acknack_payload))
     {
-        /* Send missing messages again. */
         uint16_t first_message = acknack_payload.first_unacked_seq_num();
         std::array<uint8_t, 2> nack_bitmap = acknack_payload.nack_bitmap();
         dds::xrce::SequenceNr seq_num = input_packet.message->get_header().sequence_nr();
-        for (uint16_t i = 0; i < 8; ++i)
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        /* Update output stream, round-trip time and congestion window. */
+        client.session().on_acknack_received(uint8_t(seq_num), now);
+        client.session().update_from_acknack(uint8_t(seq_num), first_message, nack_bitmap);
+
+        /* Send missing messages again, oldest first and no more than the congestion window. */
+        uint16_t window = client.session().congestion_window(uint8_t(seq_num));
+        for (uint16_t i = 0; (i < 16) && (0 < window); ++i)
         {
-            OutputPacket output_packet;
-            output_packet.destination = input_packet.source;
-            uint8_t mask = uint8_t(0x01 << i);
-            if ((nack_bitmap.at(1) & mask) == mask)
+            uint8_t mask = uint8_t(0x01 << (i % 8));
+            if ((nack_bitmap.at((i < 8) ? 1 : 0) & mask) == mask)
             {
-                if (client.session().get_output_message(uint8_t(seq_num), first_message + i, output_packet.message))
+                OutputPacket output_packet;
+                output_packet.destination = input_packet.source;
+                output_packet.budget = client.budget();
+                if (client.session().get_retransmission(uint8_t(seq_num), first_message + i, now, output_packet.message))
                 {
                     server_->push_output_packet(output_packet);
+                    --window;
                 }
             }
-            if ((nack_bitmap.at(0) & mask) == mask)
+        }
+
+        /* Resume the DataReaders waiting for room in the stream. */
+        if (!client.session().output_window_full(uint8_t(seq_num)))
+        {
+            for (const auto& object_id : client.take_output_window_waiters(uint8_t(seq_num)))
             {
-                if (client.session().get_output_message(uint8_t(seq_num), first_message + i + 8, output_packet.message))
+                DataReader* data_reader = dynamic_cast<DataReader*>(client.get_object(object_id));
+                if (nullptr != data_reader)
                 {
-                    server_->push_output_packet(output_packet);
+                    data_reader->on_output_window();
                 }
             }
         }
-
-        /* Update output stream. */
-        client.session().update_from_acknack(uint8_t(seq_num), first_message);
     }
     else
     {
@@ -474,6 +652,7 @@ bool Processor::process_heartbeat_submessage(ProxyClient& client, InputPacket& i
         /* Set output packet and serialize ACKNACK. */
         OutputPacket output_packet;
         output_packet.destination = input_packet.source;
+        output_packet.budget = client.budget();
         output_packet.message = OutputMessagePtr(new OutputMessage(acknack_header));
         output_packet.message->append_submessage(dds::xrce::ACKNACK, acknack_payload);
 
@@ -494,37 +673,124 @@ bool Processor::process_reset_submessage(ProxyClient& client, InputPacket& /*inp
     return true;
 }
 
-void Processor::read_data_callback(const ReadCallbackArgs& cb_args, const std::vector<uint8_t>& buffer)
+bool Processor::read_data_callback(const ReadCallbackArgs& cb_args, std::vector<dds::xrce::Sample>& samples)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
     std::shared_ptr<ProxyClient> client = root_->get_client(cb_args.client_key);
+    if (!client || samples.empty())
+    {
+        return true;
+    }
 
-    /* DATA header. */
-    dds::xrce::MessageHeader message_header;
-    message_header.client_key(client->get_client_key());
-    message_header.session_id(client->get_session_id());
-    message_header.stream_id(cb_args.stream_id);
-    message_header.sequence_nr(client->session().next_output_message(cb_args.stream_id));
+    /* Reliable streams only take the batch if it can be kept for retransmission. */
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (client->session().output_window_full(cb_args.stream_id))
+    {
+        client->wait_output_window(cb_args.stream_id, cb_args.object_id);
+        return false;
+    }
 
-    /* DATA payload. */
-    dds::xrce::DATA_Payload_Data payload;
-    payload.request_id(cb_args.request_id);
-    payload.object_id(cb_args.object_id);
-    payload.data().serialized_data(buffer);
+    /* DATA payload, one submessage for the whole batch. */
+    switch (cb_args.data_format)
+    {
+        case dds::xrce::FORMAT_SAMPLE:
+        {
+            dds::xrce::DATA_Payload_Sample payload;
+            payload.request_id(cb_args.request_id);
+            payload.object_id(cb_args.object_id);
+            payload.sample(std::move(samples.front()));
+            push_data_submessage(*client, cb_args, payload, dds::xrce::FORMAT_SAMPLE_FLAG);
+            break;
+        }
+        case dds::xrce::FORMAT_DATA_SEQ:
+        {
+            dds::xrce::DATA_Payload_DataSeq payload;
+            payload.request_id(cb_args.request_id);
+            payload.object_id(cb_args.object_id);
+            payload.data_seq().reserve(samples.size());
+            for (auto& sample : samples)
+            {
+                payload.data_seq().push_back(std::move(sample.data()));
+            }
+            push_data_submessage(*client, cb_args, payload, dds::xrce::FORMAT_DATA_SEQ_FLAG);
+            break;
+        }
+        case dds::xrce::FORMAT_SAMPLE_SEQ:
+        {
+            dds::xrce::DATA_Payload_SampleSeq payload;
+            payload.request_id(cb_args.request_id);
+            payload.object_id(cb_args.object_id);
+            payload.sample_seq(std::move(samples));
+            push_data_submessage(*client, cb_args, payload, dds::xrce::FORMAT_SAMPLE_SEQ_FLAG);
+            break;
+        }
+        case dds::xrce::FORMAT_PACKED_SAMPLES:
+        {
+            dds::xrce::DATA_Payload_PackedSamples payload;
+            payload.request_id(cb_args.request_id);
+            payload.object_id(cb_args.object_id);
+            const dds::xrce::SampleInfo& info_base = samples.front().info();
+            payload.packed_samples().info_base(info_base);
+            payload.packed_samples().sample_delta_seq().reserve(samples.size());
+            for (auto& sample : samples)
+            {
+                dds::xrce::SampleDelta sample_delta;
+                sample_delta.info_delta().state(sample.info().state());
+                sample_delta.info_delta().seq_number_delta(
+                            uint8_t(sample.info().sequence_number() - info_base.sequence_number()));
+                sample_delta.info_delta().timestamp_delta(
+                            dds::xrce::DeciSecond((sample.info().session_time_offset() -
+                                                   info_base.session_time_offset()) / 100));
+                sample_delta.data(std::move(sample.data()));
+                payload.packed_samples().sample_delta_seq().push_back(std::move(sample_delta));
+            }
+            push_data_submessage(*client, cb_args, payload, dds::xrce::FORMAT_PACKED_SAMPLES_FLAG);
+            break;
+        }
+        default:
+        {
+            dds::xrce::DATA_Payload_Data payload;
+            payload.request_id(cb_args.request_id);
+            payload.object_id(cb_args.object_id);
+            payload.data(std::move(samples.front().data()));
+            push_data_submessage(*client, cb_args, payload, dds::xrce::FORMAT_DATA_FLAG);
+            break;
+        }
+    }
+    return true;
+}
 
-    /* Set output packet and serialize DATA. */
+/* Called with mtx_ held, so the sequence number assignment and the storage are atomic. */
+template<class T>
+void Processor::push_data_submessage(ProxyClient& client,
+                                     const ReadCallbackArgs& cb_args,
+                                     const T& payload,
+                                     uint8_t format_flag)
+{
+    /* Set output packet. */
     OutputPacket output_packet;
     output_packet.destination = server_->get_source(cb_args.client_key);
+    output_packet.budget = client.budget();
+    output_packet.prepaid = true; /* The reader drew its samples from the client budget. */
     if (output_packet.destination)
     {
+        /* DATA header. */
+        dds::xrce::MessageHeader message_header;
+        message_header.client_key(client.get_client_key());
+        message_header.session_id(client.get_session_id());
+        message_header.stream_id(cb_args.stream_id);
+        message_header.sequence_nr(client.session().next_output_message(cb_args.stream_id));
+
+        /* Serialize DATA. */
         output_packet.message = OutputMessagePtr(new OutputMessage(message_header));
-        output_packet.message->append_submessage(dds::xrce::DATA, payload, dds::xrce::FORMAT_DATA_FLAG | 0x01);
+        output_packet.message->append_submessage(dds::xrce::DATA, payload, format_flag | 0x01);
 
         /* Store message. */
-        client->session().push_output_message(cb_args.stream_id, output_packet.message);
+        client.session().push_output_message(cb_args.stream_id, output_packet.message);
+        arm_heartbeat(client, cb_args.stream_id);
 
         /* Send message. */
         server_->push_output_packet(output_packet);
+        send_fec_parity(client, cb_args.stream_id);
     }
 }
 
@@ -572,42 +838,101 @@ bool Processor::process_get_info_packet(InputPacket&& input_packet,
     return rv;
 }
 
-void Processor::check_heartbeats()
+/* Called with mtx_ held, right after a message is stored in a reliable stream. */
+void Processor::arm_heartbeat(ProxyClient& client, uint8_t stream_id)
 {
-    root_->init_client_iteration();
-    std::shared_ptr<ProxyClient> client;
-    while (root_->get_next_client(client))
+    if ((127 < stream_id) && !client.heartbeat_armed(stream_id))
     {
-        /* Get reliable streams. */
-        for (auto stream : client->session().get_output_streams())
-        {
-            /* Get and send pending messages. */
-            if (client->session().message_pending(stream))
+        std::weak_ptr<ProxyClient> weak_client = root_->get_client(client.get_client_key());
+        Executor::TimerId timer_id = Executor::instance().schedule(client.session().heartbeat_period(stream_id),
+            [this, weak_client, stream_id]()
             {
-                /* Heartbeat message header. */
-                dds::xrce::MessageHeader heartbeat_header;
-                heartbeat_header.session_id(client->get_session_id());
-                heartbeat_header.stream_id(0x00);
-                heartbeat_header.sequence_nr(stream);
-                heartbeat_header.client_key(client->get_client_key());
-
-                /* Heartbeat message payload. */
-                dds::xrce::HEARTBEAT_Payload heartbeat_payload;
-                heartbeat_payload.first_unacked_seq_nr(client->session().get_first_unacked_seq_nr(stream));
-                heartbeat_payload.last_unacked_seq_nr(client->session().get_last_unacked_seq_nr(stream));
-
-                /* Set output packet and serialize HEARTBEAT. */
-                OutputPacket output_packet;
-                output_packet.destination = server_->get_source(client->get_client_key());
-                if (output_packet.destination)
-                {
-                    output_packet.message = OutputMessagePtr(new OutputMessage(heartbeat_header));
-                    output_packet.message->append_submessage(dds::xrce::HEARTBEAT, heartbeat_payload);
+                on_heartbeat_timer(weak_client, stream_id);
+            });
+        client.arm_heartbeat(stream_id, timer_id);
+    }
+}
 
-                    /* Send message. */
-                    server_->push_output_packet(output_packet);
-                }
-            }
+void Processor::on_heartbeat_timer(const std::weak_ptr<ProxyClient>& weak_client, uint8_t stream_id)
+{
+    std::shared_ptr<ProxyClient> client = weak_client.lock();
+    if (!client)
+    {
+        return;
+    }
+
+    /* Keep beating while there are unacknowledged messages, otherwise leave the stream idle. */
+    std::lock_guard<std::mutex> lock(mtx_);
+    client->disarm_heartbeat(stream_id);
+    if (client->session().message_pending(stream_id))
+    {
+        send_heartbeat(*client, stream_id);
+        arm_heartbeat(*client, stream_id);
+    }
+}
+
+void Processor::send_heartbeat(ProxyClient& client, uint8_t stream_id)
+{
+    /* Heartbeat message header. */
+    dds::xrce::MessageHeader heartbeat_header;
+    heartbeat_header.session_id(client.get_session_id());
+    heartbeat_header.stream_id(0x00);
+    heartbeat_header.sequence_nr(stream_id);
+    heartbeat_header.client_key(client.get_client_key());
+
+    /* Heartbeat message payload. */
+    dds::xrce::HEARTBEAT_Payload heartbeat_payload;
+    heartbeat_payload.first_unacked_seq_nr(client.session().get_first_unacked_seq_nr(stream_id));
+    heartbeat_payload.last_unacked_seq_nr(client.session().get_last_unacked_seq_nr(stream_id));
+
+    /* Set output packet and serialize HEARTBEAT. */
+    OutputPacket output_packet;
+    output_packet.destination = server_->get_source(client.get_client_key());
+    output_packet.budget = client.budget();
+    if (output_packet.destination)
+    {
+        output_packet.message = OutputMessagePtr(new OutputMessage(heartbeat_header));
+        output_packet.message->append_submessage(dds::xrce::HEARTBEAT, heartbeat_payload);
+
+        /* Send message. */
+        server_->push_output_packet(output_packet);
+        client.session().on_heartbeat_sent(stream_id, std::chrono::steady_clock::now());
+    }
+}
+
+/* Called with mtx_ held, after the message that completed a FEC group is sent. */
+void Processor::send_fec_parity(ProxyClient& client, uint8_t stream_id)
+{
+    std::vector<uint8_t> parity;
+    if (!client.session().take_fec_parity(stream_id, parity))
+    {
+        return;
+    }
+
+    /* Groups whose parity does not fit in a message, such as one of a sample larger than a batch,
+       are left to the ACKNACK recovery. */
+    if (OutputMessage::get_max_payload_size() < parity.size())
+    {
+        client.session().on_fec_parity_skipped();
+        return;
+    }
+
+    /* FEC_PARITY goes out of band like HEARTBEAT: stream 0x00 with the reliable stream as sequence number. */
+    dds::xrce::MessageHeader parity_header;
+    parity_header.session_id(client.get_session_id());
+    parity_header.stream_id(0x00);
+    parity_header.sequence_nr(stream_id);
+    parity_header.client_key(client.get_client_key());
+
+    OutputPacket output_packet;
+    output_packet.destination = server_->get_source(client.get_client_key());
+    output_packet.budget = client.budget();
+    if (output_packet.destination)
+    {
+        output_packet.message = OutputMessagePtr(new OutputMessage(parity_header));
+        if (output_packet.message->append_raw_submessage(FEC_PARITY_SUBMESSAGE_ID, parity))
+        {
+            server_->push_output_packet(output_packet);
         }
     }
 }
@@ -0,0 +1,141 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/scheduler/Executor.hpp>
+#include <uxr/agent/config.hpp>
+
+namespace eprosima {
+namespace uxr {
+
+Executor::Executor(size_t thread_count)
+    : tasks_(),
+      workers_(),
+      timer_thread_(),
+      timer_mtx_(),
+      timer_cond_(),
+      start_(std::chrono::steady_clock::now()),
+      wheel_(),
+      wake_tick_(TimerWheel::never),
+      last_timer_id_(0),
+      running_cond_(true)
+{
+    tasks_.init();
+    if (0 == thread_count)
+    {
+        thread_count = 1;
+    }
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        workers_.emplace_back(&Executor::worker_loop, this);
+    }
+    timer_thread_ = std::thread(&Executor::timer_loop, this);
+}
+
+Executor::~Executor()
+{
+    std::unique_lock<std::mutex> lock(timer_mtx_);
+    running_cond_ = false;
+    lock.unlock();
+    timer_cond_.notify_one();
+    if (timer_thread_.joinable())
+    {
+        timer_thread_.join();
+    }
+
+    tasks_.deinit();
+    for (auto& worker : workers_)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+
+Executor& Executor::instance()
+{
+    static Executor executor(EXECUTOR_THREADS);
+    return executor;
+}
+
+void Executor::post(Task&& task)
+{
+    tasks_.push(std::move(task), 0);
+}
+
+Executor::TimerId Executor::schedule(std::chrono::milliseconds delay, Task&& task)
+{
+    std::lock_guard<std::mutex> lock(timer_mtx_);
+    TimerId timer_id = ++last_timer_id_;
+    /* A partial tick counts as a whole one, so that timers never fire before their deadline. */
+    TimerWheel::Tick expiry = to_tick(std::chrono::steady_clock::now() + delay) + 1;
+    wheel_.schedule(timer_id, expiry, std::move(task));
+    if (expiry < wake_tick_)
+    {
+        timer_cond_.notify_one();
+    }
+    return timer_id;
+}
+
+bool Executor::cancel(TimerId timer_id)
+{
+    std::lock_guard<std::mutex> lock(timer_mtx_);
+    return wheel_.cancel(timer_id);
+}
+
+void Executor::worker_loop()
+{
+    Task task;
+    while (tasks_.pop(task))
+    {
+        task();
+        task = nullptr;
+    }
+}
+
+void Executor::timer_loop()
+{
+    std::vector<Task> expired;
+    std::unique_lock<std::mutex> lock(timer_mtx_);
+    while (running_cond_)
+    {
+        wheel_.advance(to_tick(std::chrono::steady_clock::now()), expired);
+        for (auto& task : expired)
+        {
+            post(std::move(task));
+        }
+        expired.clear();
+
+        /* Sleep until the wheel has something to fire or cascade, or an earlier timer is set. */
+        wake_tick_ = wheel_.next_expiry();
+        if (TimerWheel::never == wake_tick_)
+        {
+            timer_cond_.wait(lock);
+        }
+        else
+        {
+            timer_cond_.wait_until(lock, start_ + std::chrono::milliseconds(wake_tick_));
+        }
+        wake_tick_ = TimerWheel::never;
+    }
+}
+
+TimerWheel::Tick Executor::to_tick(TimePoint time_point) const
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time_point - start_).count();
+    return (0 < elapsed) ? TimerWheel::Tick(elapsed) : 0;
+}
+
+} // namespace uxr
+} // namespace eprosima
@@ -0,0 +1,164 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/scheduler/OutputScheduler.hpp>
+#include <uxr/agent/config.hpp>
+
+namespace eprosima {
+namespace uxr {
+
+OutputScheduler::OutputScheduler()
+    : backlogs_(),
+      last_served_(),
+      mtx_(),
+      cond_var_(),
+      running_cond_(false)
+{}
+
+void OutputScheduler::init()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_cond_ = true;
+}
+
+void OutputScheduler::deinit()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_cond_ = false;
+    cond_var_.notify_all();
+}
+
+void OutputScheduler::push(OutputPacket&& element, uint8_t priority)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Backlog& backlog = backlogs_[Flow(element.budget, element.pacer)];
+    backlog[(priority < backlog.size()) ? priority : (backlog.size() - 1)].push_back(std::move(element));
+
+    /* A stalled flow gives up its stale best-effort packets; reliable ones are kept for the session. */
+    size_t held = 0;
+    for (const auto& queue : backlog)
+    {
+        held += queue.size();
+    }
+    std::deque<OutputPacket>& best_effort = backlog[BEST_EFFORT_PRIORITY];
+    while ((OUTPUT_QUEUE_SIZE < held) && !best_effort.empty())
+    {
+        best_effort.pop_front();
+        --held;
+    }
+    cond_var_.notify_one();
+}
+
+bool OutputScheduler::pop(OutputPacket& element)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (running_cond_)
+    {
+        if (backlogs_.empty())
+        {
+            cond_var_.wait(lock);
+            continue;
+        }
+
+        /* Round-robin over the flows, starting after the last one served. */
+        std::chrono::microseconds wait = std::chrono::microseconds::max();
+        auto first = backlogs_.upper_bound(last_served_);
+        auto it = first;
+        for (size_t i = 0; i < backlogs_.size(); ++i, ++it)
+        {
+            if (backlogs_.end() == it)
+            {
+                it = backlogs_.begin();
+            }
+            if (pop_backlog(it->second, it->first, element, wait))
+            {
+                last_served_ = it->first;
+                bool empty = true;
+                for (const auto& queue : it->second)
+                {
+                    empty = empty && queue.empty();
+                }
+                if (empty)
+                {
+                    backlogs_.erase(it);
+                }
+                return true;
+            }
+        }
+
+        /* Every backlog is waiting for its budget or its pacer. */
+        cond_var_.wait_for(lock, wait);
+    }
+    return false;
+}
+
+uint8_t OutputScheduler::get_priority(uint8_t stream_id)
+{
+    uint8_t rv;
+    if (0x00 == stream_id)
+    {
+        rv = CONTROL_PRIORITY;
+    }
+    else if (0x80 <= stream_id)
+    {
+        rv = RELIABLE_PRIORITY;
+    }
+    else
+    {
+        rv = BEST_EFFORT_PRIORITY;
+    }
+    return rv;
+}
+
+bool OutputScheduler::pop_backlog(Backlog& backlog, const Flow& flow, OutputPacket& element,
+                                  std::chrono::microseconds& wait)
+{
+    utils::TokenBucket* budget = flow.first.get();
+    utils::Pacer* pacer = flow.second.get();
+    for (auto& queue : backlog)
+    {
+        if (queue.empty())
+        {
+            continue;
+        }
+
+        /* Only the highest priority packet may draw from the budget, once the pacer releases it. */
+        size_t size = queue.front().message->get_len();
+        if (nullptr != pacer)
+        {
+            std::chrono::microseconds delay = pacer->delay(size);
+            if (std::chrono::microseconds(0) < delay)
+            {
+                wait = std::min(wait, delay);
+                return false;
+            }
+        }
+        if ((nullptr != budget) && !queue.front().prepaid && !budget->get_tokens(size))
+        {
+            wait = std::min(wait, std::chrono::microseconds(budget->time_to_tokens(size)));
+            return false;
+        }
+        if (nullptr != pacer)
+        {
+            pacer->on_sent(size);
+        }
+        element = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    }
+    return false;
+}
+
+} // namespace uxr
+} // namespace eprosima
@@ -0,0 +1,166 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/scheduler/TimerWheel.hpp>
+#include <algorithm>
+
+namespace eprosima {
+namespace uxr {
+
+constexpr TimerWheel::Tick TimerWheel::never;
+constexpr uint8_t TimerWheel::slot_bits_;
+constexpr uint8_t TimerWheel::slot_count_;
+constexpr uint8_t TimerWheel::level_count_;
+
+TimerWheel::TimerWheel(Tick now)
+    : current_(now),
+      levels_(),
+      level_sizes_(),
+      locations_()
+{
+    level_sizes_.fill(0);
+}
+
+void TimerWheel::schedule(TimerId timer_id, Tick expiry, Task&& task)
+{
+    /* Overdue timers fire on the next tick. */
+    cancel(timer_id);
+    insert(Timer{timer_id, std::max(expiry, current_ + 1), std::move(task)});
+}
+
+bool TimerWheel::cancel(TimerId timer_id)
+{
+    bool rv = false;
+    auto it = locations_.find(timer_id);
+    if (locations_.end() != it)
+    {
+        levels_[it->second.level][it->second.slot].erase(it->second.it);
+        --level_sizes_[it->second.level];
+        locations_.erase(it);
+        rv = true;
+    }
+    return rv;
+}
+
+void TimerWheel::advance(Tick now, std::vector<Task>& expired)
+{
+    while (current_ < now)
+    {
+        /* Jump over the ticks with nothing to fire or cascade. */
+        Tick next = next_expiry();
+        if (next > now)
+        {
+            current_ = now;
+            break;
+        }
+        current_ = next;
+
+        /* Cascade the upper levels whose slot starts at this tick, from the top down. */
+        uint8_t level = 0;
+        while ((level + 1 < level_count_) && (0 == slot_index(current_, level)))
+        {
+            ++level;
+        }
+        for (; 0 < level; --level)
+        {
+            cascade(level);
+        }
+
+        /* Fire the level 0 slot. */
+        Slot& slot = levels_[0][slot_index(current_, 0)];
+        Slot pending;
+        pending.swap(slot);
+        level_sizes_[0] -= pending.size();
+        for (auto& timer : pending)
+        {
+            if (timer.expiry <= current_)
+            {
+                locations_.erase(timer.id);
+                expired.push_back(std::move(timer.task));
+            }
+            else
+            {
+                insert(std::move(timer));
+            }
+        }
+    }
+}
+
+TimerWheel::Tick TimerWheel::next_expiry() const
+{
+    Tick rv = never;
+    for (uint8_t level = 0; level < level_count_; ++level)
+    {
+        if (0 == level_sizes_[level])
+        {
+            continue;
+        }
+
+        /* First non-empty slot after the current one, in units of this level. */
+        const uint8_t shift = slot_bits_ * level;
+        const Tick unit = current_ >> shift;
+        for (uint8_t i = 1; i <= slot_count_; ++i)
+        {
+            Tick candidate = unit + i;
+            if (!levels_[level][candidate & (slot_count_ - 1)].empty())
+            {
+                rv = std::min(rv, candidate << shift);
+                break;
+            }
+        }
+    }
+    return rv;
+}
+
+void TimerWheel::insert(Timer&& timer)
+{
+    /* Timers cascaded at their own expiry tick land in the current slot, which fires next. */
+    const Tick expiry = std::max(timer.expiry, current_);
+    const Tick delta = expiry - current_;
+
+    uint8_t level = 0;
+    while ((level + 1 < level_count_) && (delta >= (Tick(1) << (slot_bits_ * (level + 1)))))
+    {
+        ++level;
+    }
+
+    /* Beyond the wheel range: park it in the farthest slot, it will be cascaded again. */
+    Tick position = expiry;
+    if (delta >= (Tick(1) << (slot_bits_ * level_count_)))
+    {
+        position = current_ + (Tick(1) << (slot_bits_ * level_count_)) - 1;
+    }
+
+    const uint8_t slot = slot_index(position, level);
+    const TimerId timer_id = timer.id;
+    Slot& list = levels_[level][slot];
+    list.push_back(std::move(timer));
+    ++level_sizes_[level];
+    locations_[timer_id] = Location{level, slot, std::prev(list.end())};
+}
+
+void TimerWheel::cascade(uint8_t level)
+{
+    Slot& slot = levels_[level][slot_index(current_, level)];
+    Slot pending;
+    pending.swap(slot);
+    level_sizes_[level] -= pending.size();
+    for (auto& timer : pending)
+    {
+        insert(std::move(timer));
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
@@ -14,9 +14,10 @@
 
 #include <uxr/agent/topic/Topic.hpp>
 #include <uxr/agent/participant/Participant.hpp>
-#include <fastrtps/Domain.h>
+#include <uxr/agent/participant/ParticipantPool.hpp>
 #include <fastrtps/xmlparser/XMLProfileManager.h>
 #include "../xmlobjects/xmlobjects.h"
+#include "../binobjects/binobjects.h"
 
 namespace eprosima {
 namespace uxr {
@@ -26,62 +27,86 @@ namespace uxr {
 Topic::Topic(const dds::xrce::ObjectId& object_id, const std::shared_ptr<Participant>& participant)
     : XRCEObject{object_id},
       participant_(participant),
-      generic_type_(false)
+      with_key_(false)
 {
     participant_->tie_object(object_id);
 }
 
 Topic::~Topic()
 {
-    fastrtps::Domain::unregisterType(participant_->get_rtps_participant(), generic_type_.getName());
-    participant_->unregister_topic(generic_type_.getName());
+    if (!type_name.empty())
+    {
+        ParticipantPool::instance().unregister_type(participant_->get_rtps_participant(), type_name);
+        participant_->unregister_topic(type_name);
+    }
     participant_->untie_object(get_id());
 }
 
 bool Topic::init(const dds::xrce::OBJK_TOPIC_Representation& representation)
 {
-    bool rv = false;
+    bool parsed = false;
+    fastrtps::TopicAttributes attributes;
     switch (representation.representation()._d())
     {
         case dds::xrce::REPRESENTATION_BY_REFERENCE:
         {
             const std::string& ref_rep = representation.representation().object_reference();
-            fastrtps::TopicAttributes attributes;
-            if (fastrtps::xmlparser::XMLP_ret::XML_OK ==
-                fastrtps::xmlparser::XMLProfileManager::fillTopicAttributes(ref_rep, attributes))
-            {
-                generic_type_.setName(attributes.getTopicDataType().data());
-                generic_type_.m_isGetKeyDefined = (attributes.getTopicKind() == fastrtps::rtps::TopicKind_t::WITH_KEY);
-                if (fastrtps::Domain::registerType(participant_->get_rtps_participant(), &generic_type_))
-                {
-                    participant_->register_topic(generic_type_.getName(), get_id());
-                    rv = true;
-                }
-            }
+            parsed = (fastrtps::xmlparser::XMLP_ret::XML_OK ==
+                      fastrtps::xmlparser::XMLProfileManager::fillTopicAttributes(ref_rep, attributes));
             break;
         }
         case dds::xrce::REPRESENTATION_AS_XML_STRING:
         {
             const std::string& xml_rep = representation.representation().xml_string_representation();
-            fastrtps::TopicAttributes attributes;
-            if (xmlobjects::parse_topic(xml_rep.data(), xml_rep.size(), attributes))
-            {
-                generic_type_.setName(attributes.getTopicDataType().data());
-                generic_type_.m_isGetKeyDefined = (attributes.getTopicKind() == fastrtps::rtps::TopicKind_t::WITH_KEY);
-                if (fastrtps::Domain::registerType(participant_->get_rtps_participant(), &generic_type_))
-                {
-                    participant_->register_topic(generic_type_.getName(), get_id());
-                    rv = true;
-                }
-            }
+            parsed = xmlobjects::parse_topic(xml_rep.data(), xml_rep.size(), attributes);
+            break;
+        }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            const std::vector<uint8_t>& bin_rep = representation.representation().binary_representation();
+            parsed = binobjects::parse_topic(bin_rep.data(), bin_rep.size(), attributes);
             break;
         }
         default:
             break;
     }
+
+    bool rv = false;
+    if (parsed)
+    {
+        bool with_key = (attributes.getTopicKind() == fastrtps::rtps::TopicKind_t::WITH_KEY);
+        if (ParticipantPool::instance().register_type(participant_->get_rtps_participant(),
+                                                      attributes.getTopicDataType().data(),
+                                                      with_key))
+        {
+            name = attributes.getTopicName().data();
+            type_name = attributes.getTopicDataType().data();
+            with_key_ = with_key;
+            participant_->register_topic(type_name, get_id());
+            rv = true;
+        }
+    }
     return rv;
 }
 
+/*
+ * Binary endpoint representations name their topic instead of carrying its type.
+ */
+std::shared_ptr<Topic> Topic::find(const ObjectContainer& root_objects,
+                                   const std::shared_ptr<Participant>& participant,
+                                   const std::string& name)
+{
+    for (const auto& object : root_objects)
+    {
+        std::shared_ptr<Topic> topic = std::dynamic_pointer_cast<Topic>(object.second);
+        if (topic && (participant == topic->participant_) && (name == topic->name))
+        {
+            return topic;
+        }
+    }
+    return nullptr;
+}
+
 void Topic::release(ObjectContainer& root_objects)
 {
     while (!tied_objects_.empty())
@@ -124,13 +149,21 @@ bool Topic::matched(const dds::xrce::ObjectVariant& new_object_rep) const
             }
             break;
         }
+        case dds::xrce::REPRESENTATION_IN_BINARY:
+        {
+            const std::vector<uint8_t>& bin_rep = new_object_rep.topic().representation().binary_representation();
+            if (binobjects::parse_topic(bin_rep.data(), bin_rep.size(), new_attributes))
+            {
+                parser_cond = true;
+            }
+            break;
+        }
         default:
             break;
     }
 
-    return parser_cond &&  (0 == std::strcmp(generic_type_.getName(), new_attributes.getTopicDataType().data())) &&
-                           (generic_type_.m_isGetKeyDefined == (new_attributes.getTopicKind() ==
-                                                                fastrtps::rtps::TopicKind_t::WITH_KEY));
+    return parser_cond &&  (type_name == new_attributes.getTopicDataType().data()) &&
+                           (with_key_ == (new_attributes.getTopicKind() == fastrtps::rtps::TopicKind_t::WITH_KEY));
 }
 
 } // namespace uxr
@@ -0,0 +1,98 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/topic/TopicBus.hpp>
+#include <uxr/agent/datareader/SharedReader.hpp>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+TopicBus& TopicBus::instance()
+{
+    static TopicBus bus;
+    return bus;
+}
+
+void TopicBus::subscribe(const Key& key, const std::weak_ptr<SharedReader>& shared_reader)
+{
+    std::lock_guard<std::mutex> lock(readers_mtx_);
+    readers_.emplace(key, shared_reader);
+}
+
+void TopicBus::add_writer(const fastrtps::rtps::GUID_t& writer_guid)
+{
+    std::lock_guard<std::mutex> lock(writers_mtx_);
+    writers_.insert(writer_guid);
+}
+
+void TopicBus::remove_writer(const fastrtps::rtps::GUID_t& writer_guid)
+{
+    std::lock_guard<std::mutex> lock(writers_mtx_);
+    auto it = writers_.find(writer_guid);
+    if (writers_.end() != it)
+    {
+        writers_.erase(it);
+    }
+}
+
+bool TopicBus::is_local_writer(const fastrtps::rtps::GUID_t& writer_guid)
+{
+    std::lock_guard<std::mutex> lock(writers_mtx_);
+    return writers_.end() != writers_.find(writer_guid);
+}
+
+size_t TopicBus::publish(const Key& key,
+                         const fastrtps::rtps::SampleIdentity& sample_identity,
+                         const uint8_t* data,
+                         size_t size)
+{
+    /* Readers are called unlocked: they take their own lock, and may ask is_local_writer under it. */
+    std::vector<std::shared_ptr<SharedReader>> readers;
+    {
+        std::lock_guard<std::mutex> lock(readers_mtx_);
+        auto range = readers_.equal_range(key);
+        for (auto it = range.first; it != range.second;)
+        {
+            std::shared_ptr<SharedReader> shared_reader = it->second.lock();
+            if (!shared_reader)
+            {
+                it = readers_.erase(it);
+                continue;
+            }
+            readers.push_back(std::move(shared_reader));
+            ++it;
+        }
+    }
+
+    size_t rv = 0;
+    if (!readers.empty())
+    {
+        SharedReader::Sample sample{std::make_shared<const std::vector<unsigned char>>(data, data + size),
+                                    fastrtps::SampleInfo_t()};
+        sample.info.sampleKind = fastrtps::rtps::ALIVE;
+        sample.info.sample_identity = sample_identity;
+        for (const auto& shared_reader : readers)
+        {
+            if (shared_reader->deliver(sample))
+            {
+                ++rv;
+            }
+        }
+    }
+    return rv;
+}
+
+} // namespace uxr
+} // namespace eprosima
@@ -48,7 +48,6 @@ bool Server::run()
     receiver_thread_.reset(new std::thread(std::bind(&Server::receiver_loop, this)));
     sender_thread_.reset(new std::thread(std::bind(&Server::sender_loop, this)));
     processing_thread_.reset(new std::thread(std::bind(&Server::processing_loop, this)));
-    heartbeat_thread_.reset(new std::thread(std::bind(&Server::heartbeat_loop, this)));
 
     return true;
 }
@@ -70,19 +69,17 @@ bool Server::stop()
     {
         processing_thread_->join();
     }
-    if (heartbeat_thread_ && heartbeat_thread_->joinable())
-    {
-        heartbeat_thread_->join();
-    }
 
     return close();
 }
 
 void Server::push_output_packet(OutputPacket output_packet)
 {
-    if (output_packet.destination && output_packet.message)
+    if (output_packet.destination && output_packet.message && output_packet.message->mark_queued())
     {
-        output_scheduler_.push(std::move(output_packet), 0);
+        uint8_t priority = OutputScheduler::get_priority(output_packet.message->get_buf()[1]);
+        output_packet.pacer = get_pacer(output_packet);
+        output_scheduler_.push(std::move(output_packet), priority);
     }
 }
 
@@ -106,6 +103,7 @@ void Server::sender_loop()
         if (output_scheduler_.pop(output_packet))
         {
             send_message(output_packet);
+            output_packet.message->mark_sent();
         }
     }
 }
@@ -122,14 +120,5 @@ void Server::processing_loop()
     }
 }
 
-void Server::heartbeat_loop()
-{
-    while (running_cond_)
-    {
-        processor_->check_heartbeats();
-        std::this_thread::sleep_for(std::chrono::milliseconds(HEARTBEAT_PERIOD));
-    }
-}
-
 } // namespace uxr
 } // namespace eprosima
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <uxr/agent/transport/udp/UDPServerBase.hpp>
+#include <uxr/agent/config.hpp>
 
 namespace eprosima {
 namespace uxr {
@@ -20,7 +21,8 @@ namespace uxr {
 UDPServerBase::UDPServerBase(uint16_t port)
     : port_(port),
       source_to_client_map_{},
-      client_to_source_map_{}
+      client_to_source_map_{},
+      pacers_{}
 {}
 
 void UDPServerBase::on_create_client(EndPoint* source, const dds::xrce::ClientKey& client_key)
@@ -65,6 +67,7 @@ void UDPServerBase::on_delete_client(EndPoint* source)
     {
         client_to_source_map_.erase(it->second);
         source_to_client_map_.erase(it->first);
+        pacers_.erase(source_id);
     }
 }
 
@@ -102,5 +105,33 @@ std::unique_ptr<EndPoint> UDPServerBase::get_source(const dds::xrce::ClientKey&
     return source;
 }
 
+std::shared_ptr<utils::Pacer> UDPServerBase::get_pacer(const OutputPacket& output_packet)
+{
+    /* The configured rate, or else the one of the client budget. */
+    size_t rate = UDP_PACING_BYTES_PER_SECOND;
+    if ((0 == rate) && output_packet.budget)
+    {
+        rate = output_packet.budget->rate();
+    }
+    if (0 == rate)
+    {
+        return nullptr;
+    }
+
+    UDPEndPoint* endpoint = static_cast<UDPEndPoint*>(output_packet.destination.get());
+    uint64_t source_id = (uint64_t(endpoint->get_addr()) << 16) | endpoint->get_port();
+    std::lock_guard<std::mutex> lock(clients_mtx_);
+    if (source_to_client_map_.end() == source_to_client_map_.find(source_id))
+    {
+        return nullptr;
+    }
+    std::shared_ptr<utils::Pacer>& pacer = pacers_[source_id];
+    if (!pacer || (pacer->rate() != rate))
+    {
+        pacer = std::make_shared<utils::Pacer>(rate, UDP_PACING_BURST);
+    }
+    return pacer;
+}
+
 } // uxr
 } // eprosima
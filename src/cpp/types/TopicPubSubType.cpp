@@ -16,6 +16,8 @@
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
 
+#include <cstring>
+
 namespace eprosima {
 namespace uxr {
 
@@ -27,15 +29,15 @@ TopicPubSubType::TopicPubSubType(bool with_key) {
 bool TopicPubSubType::serialize(void *data, rtps::SerializedPayload_t *payload)
 {
     bool rv = false;
-    std::vector<unsigned char>* buffer = reinterpret_cast<std::vector<unsigned char>*>(data);
+    SerializedDataView* view = reinterpret_cast<SerializedDataView*>(data);
     payload->data[0] = 0;
     payload->data[1] = 1;
     payload->data[2] = 0;
     payload->data[3] = 0;
-    if (buffer->size() <= (payload->max_size - 4))
+    if (view->size <= (payload->max_size - 4))
     {
-        memcpy(&payload->data[4], buffer->data(), buffer->size());
-        payload->length = uint32_t(buffer->size() + 4); //Get the serialized length
+        memcpy(&payload->data[4], view->data, view->size);
+        payload->length = uint32_t(view->size + 4); //Get the serialized length
         rv = true;
     }
     return rv;
@@ -52,7 +54,7 @@ bool TopicPubSubType::deserialize(rtps::SerializedPayload_t* payload, void* data
 std::function<uint32_t()> TopicPubSubType::getSerializedSizeProvider(void* data) {
     return [data]() -> uint32_t
     {
-        return (uint32_t)reinterpret_cast<std::vector<unsigned char>*>(data)->size() + 4 /*encapsulation*/;
+        return (uint32_t)reinterpret_cast<SerializedDataView*>(data)->size + 4 /*encapsulation*/;
     };
 }
 
@@ -0,0 +1,101 @@
+// Copyright 2017 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _XML_PARSE_CACHE_H
+#define _XML_PARSE_CACHE_H
+
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace eprosima {
+namespace uxr {
+namespace xmlobjects {
+
+/*
+ * Least recently used attributes of the XML representations parsed so far, shared by all the clients.
+ * Entries are found by the hash of the XML string and confirmed against the string itself.
+ */
+template<typename T>
+class ParseCache
+{
+public:
+    explicit ParseCache(std::size_t capacity)
+        : capacity_(capacity)
+    {}
+
+    bool find(const std::string& xml, std::size_t hash, T& attributes)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto range = index_.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second->xml == xml)
+            {
+                entries_.splice(entries_.begin(), entries_, it->second);
+                attributes = it->second->attributes;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void insert(const std::string& xml, std::size_t hash, const T& attributes)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        entries_.push_front(Entry{xml, hash, attributes});
+        index_.emplace(hash, entries_.begin());
+        if (capacity_ < entries_.size())
+        {
+            auto range = index_.equal_range(entries_.back().hash);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (std::prev(entries_.end()) == it->second)
+                {
+                    index_.erase(it);
+                    break;
+                }
+            }
+            entries_.pop_back();
+        }
+    }
+
+    std::size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return entries_.size();
+    }
+
+private:
+    struct Entry
+    {
+        std::string xml;
+        std::size_t hash;
+        T attributes;
+    };
+
+    const std::size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_multimap<std::size_t, typename std::list<Entry>::iterator> index_;
+    std::mutex mtx_;
+};
+
+} // namespace xmlobjects
+} // namespace uxr
+} // namespace eprosima
+
+#endif // !_XML_PARSE_CACHE_H
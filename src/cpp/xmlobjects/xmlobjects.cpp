@@ -13,11 +13,15 @@
 // limitations under the License.
 
 #include "xmlobjects.h"
+#include "ParseCache.h"
 
+#include <uxr/agent/config.hpp>
 #include <fastrtps/attributes/all_attributes.h>
 #include <fastrtps/xmlparser/XMLParser.h>
 #include <fastrtps/xmlparser/XMLTree.h>
 
+#include <functional>
+
 using eprosima::fastrtps::ParticipantAttributes;
 using eprosima::fastrtps::PublisherAttributes;
 using eprosima::fastrtps::SubscriberAttributes;
@@ -27,78 +31,62 @@ using eprosima::fastrtps::xmlparser::DataNode;
 using eprosima::fastrtps::xmlparser::NodeType;
 using eprosima::fastrtps::xmlparser::XMLP_ret;
 using eprosima::fastrtps::xmlparser::XMLParser;
+using eprosima::uxr::xmlobjects::ParseCache;
 
-bool eprosima::uxr::xmlobjects::parse_participant(const char* source, std::size_t source_size,
-                                                        ParticipantAttributes& participant)
+namespace {
+
+template<typename T>
+bool parse(const char* source, std::size_t source_size, NodeType type, T& attributes)
 {
+    static ParseCache<T> cache(eprosima::uxr::XML_CACHE_SIZE);
+    std::string xml(source, source_size);
+    std::size_t hash = std::hash<std::string>()(xml);
+    if ((0 != eprosima::uxr::XML_CACHE_SIZE) && cache.find(xml, hash, attributes))
+    {
+        return true;
+    }
+
     bool ret = false;
     std::unique_ptr<BaseNode> root;
     if (XMLParser::loadXML(source, source_size, root) == XMLP_ret::XML_OK)
     {
         for (const auto& profile : root->getChildren())
         {
-            if (profile->getType() == NodeType::PARTICIPANT)
+            if (profile->getType() == type)
             {
-                participant = *(dynamic_cast<DataNode<ParticipantAttributes>*>(profile.get())->get());
-                ret         = true;
+                attributes = *(dynamic_cast<DataNode<T>*>(profile.get())->get());
+                ret        = true;
             }
         }
     }
+    if (ret && (0 != eprosima::uxr::XML_CACHE_SIZE))
+    {
+        cache.insert(xml, hash, attributes);
+    }
     return ret;
 }
 
+} // unnamed namespace
+
+bool eprosima::uxr::xmlobjects::parse_participant(const char* source, std::size_t source_size,
+                                                        ParticipantAttributes& participant)
+{
+    return parse(source, source_size, NodeType::PARTICIPANT, participant);
+}
+
 bool eprosima::uxr::xmlobjects::parse_publisher(const char* source, size_t source_size,
                                                       PublisherAttributes& publisher)
 {
-    bool ret = false;
-    std::unique_ptr<BaseNode> root;
-    if (XMLParser::loadXML(source, source_size, root) == XMLP_ret::XML_OK)
-    {
-        for (const auto& profile : root->getChildren())
-        {
-            if (profile->getType() == NodeType::PUBLISHER)
-            {
-                publisher = *(dynamic_cast<DataNode<PublisherAttributes>*>(profile.get())->get());
-                ret       = true;
-            }
-        }
-    }
-    return ret;
+    return parse(source, source_size, NodeType::PUBLISHER, publisher);
 }
 
 bool eprosima::uxr::xmlobjects::parse_subscriber(const char* source, size_t source_size,
                                                        SubscriberAttributes& subscriber)
 {
-    bool ret = false;
-    std::unique_ptr<BaseNode> root;
-    if (XMLParser::loadXML(source, source_size, root) == XMLP_ret::XML_OK)
-    {
-        for (const auto& profile : root->getChildren())
-        {
-            if (profile->getType() == NodeType::SUBSCRIBER)
-            {
-                subscriber = *(dynamic_cast<DataNode<SubscriberAttributes>*>(profile.get())->get());
-                ret        = true;
-            }
-        }
-    }
-    return ret;
+    return parse(source, source_size, NodeType::SUBSCRIBER, subscriber);
 }
 
 bool eprosima::uxr::xmlobjects::parse_topic(const char* source, std::size_t source_size, TopicAttributes& topic)
 {
-    bool ret = false;
-    std::unique_ptr<BaseNode> root;
-    if (XMLParser::loadXML(source, source_size, root) == XMLP_ret::XML_OK)
-    {
-        for (const auto& profile : root->getChildren())
-        {
-            if (profile->getType() == NodeType::TOPIC)
-            {
-                topic = *(dynamic_cast<DataNode<TopicAttributes>*>(profile.get())->get());
-                ret   = true;
-            }
-        }
-    }
-    return ret;
+    return parse(source, source_size, NodeType::TOPIC, topic);
 }
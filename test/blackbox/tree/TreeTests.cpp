@@ -13,8 +13,25 @@
 // limitations under the License.
 
 #include <uxr/agent/Root.hpp>
+#include <uxr/agent/datareader/DataReader.hpp>
+#include <uxr/agent/datareader/SharedReader.hpp>
+#include <uxr/agent/datawriter/DataWriter.hpp>
+#include <uxr/agent/participant/Participant.hpp>
+#include <uxr/agent/participant/ParticipantPool.hpp>
+#include <uxr/agent/transport/Server.hpp>
+#include <uxr/agent/types/TopicPubSubType.hpp>
+#include "xmlobjects/xmlobjects.h"
 
 #include <gtest/gtest.h>
+#include <fastcdr/Cdr.h>
+#include <fastrtps/Domain.h>
+#include <fastrtps/attributes/PublisherAttributes.h>
+#include <fastrtps/publisher/Publisher.h>
+#include <fastrtps/publisher/PublisherListener.h>
+
+#include <functional>
+#include <future>
+#include <thread>
 
 namespace eprosima {
 namespace uxr {
@@ -27,7 +44,189 @@ protected:
 
     virtual ~TreeTests() = default;
 
+    static dds::xrce::CreationMode replace_mode()
+    {
+        dds::xrce::CreationMode creation_mode;
+        creation_mode.reuse(false);
+        creation_mode.replace(true);
+        return creation_mode;
+    }
+
+    /*
+     * Creates a client with the given key.
+     */
+    void create_client(const dds::xrce::ClientKey& client_key, std::shared_ptr<ProxyClient>& client)
+    {
+        dds::xrce::AGENT_Representation agent_representation;
+        dds::xrce::CLIENT_Representation client_representation;
+        client_representation.xrce_cookie(dds::xrce::XRCE_COOKIE);
+        client_representation.xrce_version(dds::xrce::XRCE_VERSION);
+        client_representation.xrce_vendor_id(vendor_id_);
+        client_representation.client_timestamp().seconds(0x00);
+        client_representation.client_timestamp().nanoseconds(0x00);
+        client_representation.client_key(client_key);
+        client_representation.session_id(0x00);
+        dds::xrce::ResultStatus response = root_.create_client(client_representation, agent_representation);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+        client = root_.get_client(client_key);
+        ASSERT_NE(nullptr, client);
+    }
+
+    /*
+     * Adds a participant and a topic from REF profiles.
+     */
+    void create_ref_topic(const std::shared_ptr<ProxyClient>& client)
+    {
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::OBJK_PARTICIPANT_Representation participant_representation;
+        participant_representation.domain_id(0);
+        participant_representation.representation().object_reference("default_xrce_participant");
+        object_variant.participant(participant_representation);
+        dds::xrce::ResultStatus response = client->create(creation_mode_, {0x00, 0x01}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+        dds::xrce::OBJK_TOPIC_Representation topic_representation;
+        topic_representation.participant_id({0x00, 0x01});
+        topic_representation.representation().object_reference("shapetype_topic");
+        object_variant.topic(topic_representation);
+        response = client->create(creation_mode_, {0x00, 0x22}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    }
+
+    /*
+     * Adds a publisher, and a datawriter on the topic from its REF profile.
+     */
+    void create_ref_writer(const std::shared_ptr<ProxyClient>& client, DataWriter*& datawriter)
+    {
+        ASSERT_NO_FATAL_FAILURE(create_publisher(client));
+
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::DATAWRITER_Representation datawriter_representation;
+        datawriter_representation.publisher_id({0x00, 0x13});
+        datawriter_representation.representation().object_reference("shapetype_data_writer");
+        object_variant.data_writer(datawriter_representation);
+        dds::xrce::ResultStatus response = client->create(creation_mode_, {0x00, 0x15}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+        datawriter = dynamic_cast<DataWriter*>(client->get_object({0x00, 0x15}));
+        ASSERT_NE(nullptr, datawriter);
+    }
+
+    void create_publisher(const std::shared_ptr<ProxyClient>& client)
+    {
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::OBJK_PUBLISHER_Representation publisher_representation;
+        publisher_representation.participant_id({0x00, 0x01});
+        publisher_representation.representation().string_representation("");
+        object_variant.publisher(publisher_representation);
+        dds::xrce::ResultStatus response = client->create(creation_mode_, {0x00, 0x13}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    }
+
+    /*
+     * Adds a subscriber, and a datareader on the topic from its REF profile.
+     */
+    void create_ref_reader(const std::shared_ptr<ProxyClient>& client, DataReader*& datareader)
+    {
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::OBJK_SUBSCRIBER_Representation subscriber_representation;
+        subscriber_representation.participant_id({0x00, 0x01});
+        subscriber_representation.representation().string_representation("");
+        object_variant.subscriber(subscriber_representation);
+        dds::xrce::ResultStatus response = client->create(creation_mode_, {0x00, 0x14}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+        dds::xrce::DATAREADER_Representation datareader_representation;
+        datareader_representation.subscriber_id({0x00, 0x14});
+        datareader_representation.representation().object_reference("shapetype_data_reader");
+        object_variant.data_reader(datareader_representation);
+        response = client->create(creation_mode_, {0x00, 0x16}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+        datareader = dynamic_cast<DataReader*>(client->get_object({0x00, 0x16}));
+        ASSERT_NE(nullptr, datareader);
+    }
+
+    /*
+     * Creates a client with a matched datawriter and datareader, both from REF profiles.
+     */
+    void create_read_write_tree(std::shared_ptr<ProxyClient>& client, DataWriter*& datawriter, DataReader*& datareader)
+    {
+        ASSERT_NO_FATAL_FAILURE(create_client(client_key_, client));
+        ASSERT_NO_FATAL_FAILURE(create_ref_topic(client));
+        ASSERT_NO_FATAL_FAILURE(create_ref_writer(client, datawriter));
+        ASSERT_NO_FATAL_FAILURE(create_ref_reader(client, datareader));
+        for (int i = 0; (i < 100) && (0 == datareader->matched_); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_LT(0, datareader->matched_);
+    }
+
+    /*
+     * Creates another client with a datareader from the same REF profiles.
+     */
+    void create_reader_tree(const dds::xrce::ClientKey& client_key,
+                            std::shared_ptr<ProxyClient>& client,
+                            DataReader*& datareader)
+    {
+        ASSERT_NO_FATAL_FAILURE(create_client(client_key, client));
+        ASSERT_NO_FATAL_FAILURE(create_ref_topic(client));
+        ASSERT_NO_FATAL_FAILURE(create_ref_reader(client, datareader));
+    }
+
+    /*
+     * Creates a client with a participant, a topic and a publisher from REF profiles, and a
+     * datawriter on the topic from XML with the given QoS.
+     */
+    void create_xml_writer_tree(std::shared_ptr<ProxyClient>& client, const std::string& qos, DataWriter*& datawriter)
+    {
+        ASSERT_NO_FATAL_FAILURE(create_client(client_key_, client));
+        ASSERT_NO_FATAL_FAILURE(create_ref_topic(client));
+        ASSERT_NO_FATAL_FAILURE(create_publisher(client));
+
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::DATAWRITER_Representation datawriter_representation;
+        datawriter_representation.publisher_id({0x00, 0x13});
+        datawriter_representation.representation().xml_string_representation(
+                    "<dds><data_writer>"
+                        "<topic><kind>WITH_KEY</kind><name>Square</name><dataType>ShapeType</dataType></topic>"
+                        "<qos>" + qos + "</qos>"
+                    "</data_writer></dds>");
+        object_variant.data_writer(datawriter_representation);
+        dds::xrce::ResultStatus response = client->create(creation_mode_, {0x00, 0x15}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+        datawriter = dynamic_cast<DataWriter*>(client->get_object({0x00, 0x15}));
+        ASSERT_NE(nullptr, datawriter);
+    }
+
+    /*
+     * Adds a subscriber and a datareader on the topic from XML with the given QoS.
+     */
+    void create_xml_reader(const std::shared_ptr<ProxyClient>& client, const std::string& qos, DataReader*& datareader)
+    {
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::OBJK_SUBSCRIBER_Representation subscriber_representation;
+        subscriber_representation.participant_id({0x00, 0x01});
+        subscriber_representation.representation().string_representation("");
+        object_variant.subscriber(subscriber_representation);
+        dds::xrce::ResultStatus response = client->create(creation_mode_, {0x00, 0x14}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+        dds::xrce::DATAREADER_Representation datareader_representation;
+        datareader_representation.subscriber_id({0x00, 0x14});
+        datareader_representation.representation().xml_string_representation(
+                    "<dds><data_reader>"
+                        "<topic><kind>WITH_KEY</kind><name>Square</name><dataType>ShapeType</dataType></topic>"
+                        "<qos>" + qos + "</qos>"
+                    "</data_reader></dds>");
+        object_variant.data_reader(datareader_representation);
+        response = client->create(creation_mode_, {0x00, 0x16}, object_variant);
+        ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+        datareader = dynamic_cast<DataReader*>(client->get_object({0x00, 0x16}));
+        ASSERT_NE(nullptr, datareader);
+    }
+
     eprosima::uxr::Root root_;
+    dds::xrce::CreationMode creation_mode_      = replace_mode();
     const dds::xrce::ClientKey client_key_      = {{0xF1, 0xF2, 0xF3, 0xF4}};
     const dds::xrce::XrceVendorId vendor_id_    = {{0x00, 0x01}};
 };
@@ -937,6 +1136,1198 @@ TEST_F(TreeTests, CreationModeREFTree)
     ASSERT_EQ(dds::xrce::STATUS_OK_MATCHED, response.status());
 }
 
+TEST_F(TreeTests, ReadReArmLatency)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    /*
+     * Block the delivery inside the callback, as a slow output path would do,
+     * and check that re-arming the read does not wait for it.
+     */
+    std::promise<void> delivering;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> deliveries{0};
+    auto read_cb = [&](const ReadCallbackArgs&, std::vector<dds::xrce::Sample>&)
+    {
+        if (1 == ++deliveries)
+        {
+            delivering.set_value();
+            released.wait();
+        }
+        return true;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(10);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ReadCallbackArgs cb_args;
+    datareader->read(read_payload, read_cb, cb_args);
+
+    std::vector<uint8_t> sample(16, 0xAA);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    ASSERT_EQ(std::future_status::ready, delivering.get_future().wait_for(std::chrono::seconds(5)));
+
+    auto start = std::chrono::steady_clock::now();
+    datareader->read(read_payload, read_cb, cb_args);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    release.set_value();
+    ASSERT_GT(50, elapsed.count());
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, ReadDataSeqBatch)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    const size_t sample_count = 5;
+    std::vector<uint8_t> sample(40, 0xAA);
+    for (size_t i = 0; i < sample_count; ++i)
+    {
+        ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    /* All the samples fit in a single DATA submessage. */
+    std::mutex mtx;
+    std::vector<size_t> batches;
+    std::promise<void> done;
+    size_t delivered = 0;
+    auto read_cb = [&](const ReadCallbackArgs& cb_args, std::vector<dds::xrce::Sample>& samples)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        EXPECT_EQ(dds::xrce::FORMAT_DATA_SEQ, cb_args.data_format);
+        batches.push_back(samples.size());
+        delivered += samples.size();
+        if (sample_count == delivered)
+        {
+            done.set_value();
+        }
+        return true;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    read_payload.read_specification().data_format(dds::xrce::FORMAT_DATA_SEQ);
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(sample_count);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ReadCallbackArgs cb_args;
+    cb_args.max_batch_size = 500;
+    datareader->read(read_payload, read_cb, cb_args);
+
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ(std::vector<size_t>{sample_count}, batches);
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, ReadMinPacePeriod)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    auto write_samples = [&](uint8_t first, uint8_t last)
+    {
+        for (uint8_t i = first; i <= last; ++i)
+        {
+            std::vector<uint8_t> sample(8, i);
+            ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    };
+    ASSERT_NO_FATAL_FAILURE(write_samples(0, 4));
+
+    /* Only the most recent sample of each period is delivered. */
+    std::mutex mtx;
+    std::vector<uint8_t> delivered;
+    std::vector<std::chrono::steady_clock::time_point> times;
+    std::promise<void> first;
+    std::promise<void> done;
+    auto read_cb = [&](const ReadCallbackArgs& /*cb_args*/, std::vector<dds::xrce::Sample>& samples)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto& sample : samples)
+        {
+            delivered.push_back(sample.data().serialized_data().at(0));
+            times.push_back(std::chrono::steady_clock::now());
+        }
+        if (1 == delivered.size())
+        {
+            first.set_value();
+        }
+        else if (2 == delivered.size())
+        {
+            done.set_value();
+        }
+        return true;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    read_payload.read_specification().data_format(dds::xrce::FORMAT_DATA);
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(2);
+    delivery_control.min_pace_period() = 200;
+    read_payload.read_specification().delivery_control(delivery_control);
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, ReadCallbackArgs{}));
+
+    ASSERT_EQ(std::future_status::ready, first.get_future().wait_for(std::chrono::seconds(5)));
+    ASSERT_NO_FATAL_FAILURE(write_samples(5, 7));
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ((std::vector<uint8_t>{4, 7}), delivered);
+    ASSERT_LE(195, std::chrono::duration_cast<std::chrono::milliseconds>(times[1] - times[0]).count());
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, ReadKeepLatest)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    const uint8_t sample_count = 8;
+    for (uint8_t i = 0; i < sample_count; ++i)
+    {
+        std::vector<uint8_t> sample(20000, i);
+        ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    /* The bucket holds three samples, the ones waiting for it are conflated into the newest. */
+    std::mutex mtx;
+    std::vector<uint8_t> delivered;
+    std::promise<void> done;
+    auto read_cb = [&](const ReadCallbackArgs& /*cb_args*/, std::vector<dds::xrce::Sample>& samples)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto& sample : samples)
+        {
+            delivered.push_back(sample.data().serialized_data().at(0));
+        }
+        if (4 == delivered.size())
+        {
+            done.set_value();
+        }
+        return true;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    read_payload.read_specification().data_format(dds::xrce::FORMAT_DATA);
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(4);
+    delivery_control.max_bytes_per_second(64000);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ReadCallbackArgs cb_args;
+    cb_args.keep_latest = true;
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, cb_args));
+
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ((std::vector<uint8_t>{0, 1, 2, 7}), delivered);
+    ASSERT_EQ(4u, datareader->conflated_samples());
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, ReadPacedKeepLatest)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        std::vector<uint8_t> sample(20000, i);
+        ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::mutex mtx;
+    std::vector<uint8_t> delivered;
+    std::promise<void> first;
+    std::promise<void> done;
+    auto read_cb = [&](const ReadCallbackArgs& /*cb_args*/, std::vector<dds::xrce::Sample>& samples)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto& sample : samples)
+        {
+            delivered.push_back(sample.data().serialized_data().at(0));
+        }
+        if (1 == delivered.size())
+        {
+            first.set_value();
+        }
+        else if (2 == delivered.size())
+        {
+            done.set_value();
+        }
+        return true;
+    };
+
+    /* The bucket holds one sample: the others are conflated while waiting for it. */
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    read_payload.read_specification().data_format(dds::xrce::FORMAT_DATA);
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(10);
+    delivery_control.max_bytes_per_second(20000);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ReadCallbackArgs cb_args;
+    cb_args.keep_latest = true;
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, cb_args));
+    ASSERT_EQ(std::future_status::ready, first.get_future().wait_for(std::chrono::seconds(5)));
+    for (int i = 0; (i < 100) && (2u != datareader->conflated_samples()); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(2u, datareader->conflated_samples());
+
+    /* A paced read on the exhausted bucket delivers the newest of them, not nothing. */
+    delivery_control.min_pace_period() = 100;
+    read_payload.read_specification().delivery_control(delivery_control);
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, cb_args));
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ((std::vector<uint8_t>{0, 3}), delivered);
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+/*
+ * The agent does not compute keys yet: a writer of its own, keyed on the first byte, stands for a
+ * remote one updating several instances.
+ */
+class KeyedPubSubType : public TopicPubSubType
+{
+public:
+    KeyedPubSubType()
+        : TopicPubSubType(true)
+    {
+        setName("ShapeType");
+        m_typeSize = 20000 + 4;
+    }
+
+    bool getKey(void* data, rtps::InstanceHandle_t* handle) override
+    {
+        handle->value[0] = reinterpret_cast<SerializedDataView*>(data)->data[0];
+        return true;
+    }
+};
+
+class MatchedListener : public fastrtps::PublisherListener
+{
+public:
+    void onPublicationMatched(fastrtps::Publisher*, fastrtps::rtps::MatchingInfo& info) override
+    {
+        matched += (info.status == fastrtps::rtps::MATCHED_MATCHING) ? 1 : -1;
+    }
+
+    std::atomic<int> matched{0};
+};
+
+TEST_F(TreeTests, ReadPacedKeepLatestInstances)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_client(client_key_, client));
+    ASSERT_NO_FATAL_FAILURE(create_ref_topic(client));
+    ASSERT_NO_FATAL_FAILURE(create_xml_reader(client, "<reliability><kind>RELIABLE</kind></reliability>", datareader));
+
+    fastrtps::ParticipantAttributes participant_attributes;
+    participant_attributes.rtps.builtin.domainId = 0;
+    participant_attributes.rtps.setName("keyed_writer");
+    fastrtps::Participant* rtps_participant = fastrtps::Domain::createParticipant(participant_attributes);
+    ASSERT_NE(nullptr, rtps_participant);
+    KeyedPubSubType type;
+    ASSERT_TRUE(fastrtps::Domain::registerType(rtps_participant, &type));
+    fastrtps::PublisherAttributes publisher_attributes;
+    publisher_attributes.topic.topicKind = fastrtps::rtps::WITH_KEY;
+    publisher_attributes.topic.topicName = "Square";
+    publisher_attributes.topic.topicDataType = "ShapeType";
+    publisher_attributes.topic.historyQos.kind = fastrtps::KEEP_ALL_HISTORY_QOS;
+    publisher_attributes.qos.m_reliability.kind = fastrtps::RELIABLE_RELIABILITY_QOS;
+    MatchedListener listener;
+    fastrtps::Publisher* rtps_publisher =
+            fastrtps::Domain::createPublisher(rtps_participant, publisher_attributes, &listener);
+    ASSERT_NE(nullptr, rtps_publisher);
+    for (int i = 0; (i < 500) && ((0 == listener.matched) || (0 == datareader->matched_)); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_NE(0, listener.matched);
+
+    /* Instances A and B updated alternately: A0, A1, B2, A3. */
+    const uint8_t instances[] = {0x0A, 0x0A, 0x0B, 0x0A};
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        std::vector<uint8_t> sample(20000, i);
+        sample[0] = instances[i];
+        SerializedDataView view{sample.data(), sample.size()};
+        ASSERT_TRUE(rtps_publisher->write(&view));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::mutex mtx;
+    std::vector<uint8_t> delivered;
+    std::promise<void> first;
+    std::promise<void> done;
+    auto read_cb = [&](const ReadCallbackArgs& /*cb_args*/, std::vector<dds::xrce::Sample>& samples)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto& sample : samples)
+        {
+            delivered.push_back(sample.data().serialized_data().at(1));
+        }
+        if (1 == delivered.size())
+        {
+            first.set_value();
+        }
+        else if (2 == delivered.size())
+        {
+            done.set_value();
+        }
+        return true;
+    };
+
+    /* A0 empties the bucket: A3 then takes the slot of A1, ahead of B2. */
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    read_payload.read_specification().data_format(dds::xrce::FORMAT_DATA);
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(10);
+    delivery_control.max_bytes_per_second(20000);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ReadCallbackArgs cb_args;
+    cb_args.keep_latest = true;
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, cb_args));
+    ASSERT_EQ(std::future_status::ready, first.get_future().wait_for(std::chrono::seconds(5)));
+    for (int i = 0; (i < 100) && (1u != datareader->conflated_samples()); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, datareader->conflated_samples());
+
+    /* The paced read delivers the newest sample, whatever its slot. */
+    delivery_control.min_pace_period() = 100;
+    read_payload.read_specification().delivery_control(delivery_control);
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, cb_args));
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ((std::vector<uint8_t>{0, 3}), delivered);
+
+    /* Participants destruction. */
+    ASSERT_TRUE(fastrtps::Domain::removeParticipant(rtps_participant));
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, ReadPausesOnFullOutputWindow)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    std::vector<uint8_t> sample(8, 0);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    /* A refused sample is kept and offered again once the window is reported free. */
+    std::mutex mtx;
+    std::vector<uint8_t> attempts;
+    bool window_full = true;
+    std::promise<void> done;
+    auto read_cb = [&](const ReadCallbackArgs& /*cb_args*/, std::vector<dds::xrce::Sample>& samples)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        attempts.push_back(samples.front().data().serialized_data().at(0));
+        if (!window_full && (1 == attempts.back()))
+        {
+            done.set_value();
+        }
+        return !window_full;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(2);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, ReadCallbackArgs{}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    /* New data does not wake up a paused delivery. */
+    sample.assign(8, 1);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        ASSERT_EQ(std::vector<uint8_t>{0}, attempts);
+        window_full = false;
+    }
+
+    datareader->on_output_window();
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ((std::vector<uint8_t>{0, 0, 1}), attempts);
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, ReadKeepLatestOnFullOutputWindow)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    std::vector<uint8_t> sample(8, 0);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::mutex mtx;
+    std::vector<uint8_t> attempts;
+    bool window_full = true;
+    std::promise<void> done;
+    auto read_cb = [&](const ReadCallbackArgs& /*cb_args*/, std::vector<dds::xrce::Sample>& samples)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        attempts.push_back(samples.front().data().serialized_data().at(0));
+        if (!window_full)
+        {
+            done.set_value();
+        }
+        return !window_full;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(5);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ReadCallbackArgs cb_args;
+    cb_args.keep_latest = true;
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, cb_args));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    /* While the window is full, newer samples replace the refused one and each other. */
+    for (uint8_t i = 1; i <= 3; ++i)
+    {
+        sample.assign(8, i);
+        ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        ASSERT_EQ(std::vector<uint8_t>{0}, attempts);
+        window_full = false;
+    }
+    ASSERT_EQ(3u, datareader->conflated_samples());
+
+    datareader->on_output_window();
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ((std::vector<uint8_t>{0, 3}), attempts);
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, SharedParticipant)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    /* A second client with the same participant profile and topic. */
+    std::shared_ptr<ProxyClient> other_client;
+    ASSERT_NO_FATAL_FAILURE(create_client({{0xA1, 0xA2, 0xA3, 0xA4}}, other_client));
+    ASSERT_NO_FATAL_FAILURE(create_ref_topic(other_client));
+
+    /* Both XRCE participants map onto one RTPS participant. */
+    Participant* participant = dynamic_cast<Participant*>(client->get_object({0x00, 0x01}));
+    Participant* other_participant = dynamic_cast<Participant*>(other_client->get_object({0x00, 0x01}));
+    ASSERT_NE(nullptr, participant);
+    ASSERT_NE(nullptr, other_participant);
+    fastrtps::Participant* rtps_participant = participant->get_rtps_participant();
+    ASSERT_EQ(rtps_participant, other_participant->get_rtps_participant());
+    ASSERT_EQ(2u, ParticipantPool::instance().references(rtps_participant));
+
+    /* It outlives the first client's participant. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_EQ(1u, ParticipantPool::instance().references(rtps_participant));
+
+    response = other_client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_EQ(0u, ParticipantPool::instance().references(rtps_participant));
+}
+
+TEST_F(TreeTests, SharedReaderFanOut)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    /* The second reader joins the RTPS subscriber of the first one, already matched. */
+    std::shared_ptr<ProxyClient> other_client;
+    DataReader* other_datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_reader_tree({{0xA1, 0xA2, 0xA3, 0xA4}}, other_client, other_datareader));
+    if (SHARED_READERS)
+    {
+        ASSERT_EQ(datareader->matched_, other_datareader->matched_);
+    }
+
+    std::promise<std::vector<unsigned char>> received;
+    std::promise<std::vector<unsigned char>> other_received;
+    auto read_cb = [&](const ReadCallbackArgs&, std::vector<dds::xrce::Sample>& samples)
+    {
+        received.set_value(samples.front().data().serialized_data());
+        return true;
+    };
+    auto other_read_cb = [&](const ReadCallbackArgs&, std::vector<dds::xrce::Sample>& samples)
+    {
+        other_received.set_value(samples.front().data().serialized_data());
+        return true;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, ReadCallbackArgs{}));
+    ASSERT_TRUE(other_datareader->read(read_payload, other_read_cb, ReadCallbackArgs{}));
+
+    /* One write reaches both clients. */
+    std::vector<uint8_t> sample(16, 0xAB);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    std::future<std::vector<unsigned char>> future = received.get_future();
+    std::future<std::vector<unsigned char>> other_future = other_received.get_future();
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(5)));
+    ASSERT_EQ(std::future_status::ready, other_future.wait_for(std::chrono::seconds(5)));
+    ASSERT_EQ(sample, future.get());
+    ASSERT_EQ(sample, other_future.get());
+
+    /* The shared subscriber outlives the first reader. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    response = other_client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, SharedReaderDepthPerInstance)
+{
+    fastrtps::ParticipantAttributes participant_attributes;
+    participant_attributes.rtps.builtin.domainId = 0;
+    participant_attributes.rtps.setName("depth_per_instance");
+    fastrtps::Participant* rtps_participant = ParticipantPool::instance().acquire(participant_attributes);
+    ASSERT_NE(nullptr, rtps_participant);
+    ASSERT_TRUE(ParticipantPool::instance().register_type(rtps_participant, "ShapeType", true));
+
+    fastrtps::SubscriberAttributes attributes;
+    attributes.topic.topicKind = fastrtps::rtps::WITH_KEY;
+    attributes.topic.topicName = "Square";
+    attributes.topic.topicDataType = "ShapeType";
+    attributes.topic.historyQos.kind = fastrtps::KEEP_LAST_HISTORY_QOS;
+    attributes.topic.historyQos.depth = 1;
+    attributes.qos.m_durability.kind = fastrtps::TRANSIENT_LOCAL_DURABILITY_QOS;
+    std::shared_ptr<SharedReader> shared_reader = SharedReader::acquire(rtps_participant, attributes);
+    ASSERT_NE(nullptr, shared_reader);
+    std::shared_ptr<SharedReader::Binding> binding = shared_reader->bind([](){}, [](int){});
+
+    /* A matched writer updating two instances: A, B and then A again. */
+    fastrtps::rtps::MatchingInfo matching_info;
+    matching_info.status = fastrtps::rtps::MATCHED_MATCHING;
+    shared_reader->onSubscriptionMatched(nullptr, matching_info);
+    auto make_sample = [](uint8_t instance, uint32_t seq_num)
+    {
+        SharedReader::Sample sample;
+        sample.data = std::make_shared<const std::vector<unsigned char>>(4, seq_num);
+        sample.info.iHandle.value[0] = instance;
+        sample.info.sample_identity.sequence_number().low = seq_num;
+        return sample;
+    };
+    ASSERT_TRUE(shared_reader->deliver(make_sample(0x0A, 1)));
+    ASSERT_TRUE(shared_reader->deliver(make_sample(0x0B, 2)));
+    ASSERT_TRUE(shared_reader->deliver(make_sample(0x0A, 3)));
+
+    /* Depth 1 keeps the last sample of each instance, for the binding and for a late one. */
+    std::shared_ptr<SharedReader::Binding> late_binding = shared_reader->bind([](){}, [](int){});
+    for (const auto& current : {binding, late_binding})
+    {
+        std::vector<unsigned char> data;
+        fastrtps::SampleInfo_t info;
+        ASSERT_EQ(2u, current->unread_count());
+        ASSERT_TRUE(current->take_next(data, info));
+        ASSERT_EQ(0x0B, info.iHandle.value[0]);
+        ASSERT_EQ(std::vector<unsigned char>(4, 2), data);
+        ASSERT_TRUE(current->take_next(data, info));
+        ASSERT_EQ(0x0A, info.iHandle.value[0]);
+        ASSERT_EQ(std::vector<unsigned char>(4, 3), data);
+        ASSERT_FALSE(current->take_next(data, info));
+    }
+
+    shared_reader->unbind(binding);
+    shared_reader->unbind(late_binding);
+    shared_reader.reset();
+    ParticipantPool::instance().unregister_type(rtps_participant, "ShapeType");
+    ParticipantPool::instance().release(rtps_participant);
+}
+
+TEST_F(TreeTests, SharedWriterAccounting)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    std::shared_ptr<ProxyClient> other_client;
+    DataReader* other_datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_reader_tree({{0xA1, 0xA2, 0xA3, 0xA4}}, other_client, other_datareader));
+
+    /* A second client's datawriter from the same profile. */
+    dds::xrce::CreationMode creation_mode;
+    creation_mode.reuse(false);
+    creation_mode.replace(true);
+    dds::xrce::ObjectVariant object_variant;
+    dds::xrce::OBJK_PUBLISHER_Representation publisher_representation;
+    publisher_representation.participant_id({0x00, 0x01});
+    publisher_representation.representation().string_representation("");
+    object_variant.publisher(publisher_representation);
+    dds::xrce::ResultStatus response = other_client->create(creation_mode, {0x00, 0x13}, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    dds::xrce::DATAWRITER_Representation datawriter_representation;
+    datawriter_representation.publisher_id({0x00, 0x13});
+    datawriter_representation.representation().object_reference("shapetype_data_writer");
+    object_variant.data_writer(datawriter_representation);
+    response = other_client->create(creation_mode, {0x00, 0x15}, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    DataWriter* other_datawriter = dynamic_cast<DataWriter*>(other_client->get_object({0x00, 0x15}));
+    ASSERT_NE(nullptr, other_datawriter);
+
+    if (SHARED_WRITERS)
+    {
+        ASSERT_EQ(datawriter->get_rtps_publisher(), other_datawriter->get_rtps_publisher());
+    }
+    else
+    {
+        ASSERT_NE(datawriter->get_rtps_publisher(), other_datawriter->get_rtps_publisher());
+    }
+
+    /* Each datawriter accounts for its own writes only. */
+    std::vector<uint8_t> sample(16, 0xAB);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    ASSERT_TRUE(other_datawriter->write(sample.data(), 8));
+    ASSERT_EQ(2u, datawriter->get_write_stats().samples);
+    ASSERT_EQ(32u, datawriter->get_write_stats().bytes);
+    ASSERT_EQ(1u, other_datawriter->get_write_stats().samples);
+    ASSERT_EQ(8u, other_datawriter->get_write_stats().bytes);
+
+    /* The shared publisher outlives the first datawriter. */
+    response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_TRUE(other_datawriter->write(sample.data(), sample.size()));
+    ASSERT_EQ(0u, other_datawriter->get_write_stats().errors);
+    response = other_client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, TopicBusDeliversOnce)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_read_write_tree(client, datawriter, datareader));
+
+    std::atomic<int> deliveries{0};
+    std::promise<void> delivered;
+    auto read_cb = [&](const ReadCallbackArgs&, std::vector<dds::xrce::Sample>& samples)
+    {
+        if (1 == (deliveries += int(samples.size())))
+        {
+            delivered.set_value();
+        }
+        return true;
+    };
+
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    dds::xrce::DataDeliveryControl delivery_control;
+    delivery_control.max_samples(10);
+    read_payload.read_specification().delivery_control(delivery_control);
+    ReadCallbackArgs cb_args;
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, cb_args));
+
+    std::vector<uint8_t> sample(16, 0xAA);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    ASSERT_EQ(std::future_status::ready, delivered.get_future().wait_for(std::chrono::seconds(5)));
+
+    /* The RTPS copy of a local sample is not delivered again. */
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ASSERT_EQ(1, deliveries);
+
+    /* Participant destruction. */
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, TopicBusLateJoiner)
+{
+    const std::string qos = "<durability><kind>TRANSIENT_LOCAL</kind></durability>"
+                            "<reliability><kind>RELIABLE</kind></reliability>";
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_xml_writer_tree(client, qos, datawriter));
+
+    std::vector<uint8_t> sample(16, 0xAC);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+
+    /* The reader comes after the write: it gets the writer's history through RTPS. */
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_xml_reader(client, qos, datareader));
+
+    std::promise<std::vector<unsigned char>> received;
+    auto read_cb = [&](const ReadCallbackArgs&, std::vector<dds::xrce::Sample>& samples)
+    {
+        received.set_value(samples.front().data().serialized_data());
+        return true;
+    };
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, ReadCallbackArgs{}));
+
+    std::future<std::vector<unsigned char>> future = received.get_future();
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(5)));
+    ASSERT_EQ(sample, future.get());
+
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, TopicBusMatchesPartitions)
+{
+    std::shared_ptr<ProxyClient> client;
+    DataWriter* datawriter = nullptr;
+    DataReader* datareader = nullptr;
+    ASSERT_NO_FATAL_FAILURE(create_xml_writer_tree(client, "<partition><names><name>A</name></names></partition>", datawriter));
+    ASSERT_NO_FATAL_FAILURE(create_xml_reader(client, "<partition><names><name>B</name></names></partition>", datareader));
+
+    std::atomic<int> deliveries{0};
+    auto read_cb = [&](const ReadCallbackArgs&, std::vector<dds::xrce::Sample>& samples)
+    {
+        deliveries += int(samples.size());
+        return true;
+    };
+    dds::xrce::READ_DATA_Payload read_payload;
+    read_payload.object_id({0x00, 0x16});
+    ASSERT_TRUE(datareader->read(read_payload, read_cb, ReadCallbackArgs{}));
+
+    /* Same topic and type, but RTPS does not match them: neither does the bus. */
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    std::vector<uint8_t> sample(16, 0xAD);
+    ASSERT_TRUE(datawriter->write(sample.data(), sample.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ASSERT_EQ(0, datareader->matched_);
+    ASSERT_EQ(0, deliveries);
+
+    dds::xrce::ResultStatus response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, BinaryTree)
+{
+    /* Little endian CDR, as the clients serialize the binary representations. */
+    auto serialize = [](const std::function<void (fastcdr::Cdr&)>& body)
+    {
+        fastcdr::FastBuffer buffer;
+        fastcdr::Cdr serializer(buffer, fastcdr::Cdr::LITTLE_ENDIANNESS);
+        body(serializer);
+        return std::vector<uint8_t>(buffer.getBuffer(), buffer.getBuffer() + serializer.getSerializedDataLength());
+    };
+
+    std::shared_ptr<ProxyClient> client;
+    ASSERT_NO_FATAL_FAILURE(create_client(client_key_, client));
+    dds::xrce::ResultStatus response;
+
+    dds::xrce::CreationMode creation_mode;
+    creation_mode.reuse(false);
+    creation_mode.replace(true);
+    dds::xrce::ObjectVariant object_variant;
+
+    /* Participant: no domain nor QoS profile reference. */
+    dds::xrce::OBJK_PARTICIPANT_Representation participant_representation;
+    participant_representation.domain_id(0);
+    participant_representation.representation().binary_representation(serialize([](fastcdr::Cdr& cdr)
+    {
+        cdr << false << false;
+    }));
+    object_variant.participant(participant_representation);
+    dds::xrce::ObjectPrefix participant_id = {0x00, 0x01};
+    response = client->create(creation_mode, participant_id, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    /* Topic: name and type reference. */
+    dds::xrce::OBJK_TOPIC_Representation topic_representation;
+    topic_representation.participant_id(participant_id);
+    topic_representation.representation().binary_representation(serialize([](fastcdr::Cdr& cdr)
+    {
+        cdr << std::string("HelloWorldTopic") << true << std::string("HelloWorld") << false;
+    }));
+    object_variant.topic(topic_representation);
+    response = client->create(creation_mode, {0x00, 0x22}, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    dds::xrce::OBJK_PUBLISHER_Representation publisher_representation;
+    publisher_representation.participant_id(participant_id);
+    publisher_representation.representation().string_representation("");
+    object_variant.publisher(publisher_representation);
+    dds::xrce::ObjectPrefix publisher_id = {0x00, 0x13};
+    response = client->create(creation_mode, publisher_id, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    /* Datawriter: reliable, keep last 5. */
+    std::vector<uint8_t> datawriter_bin = serialize([](fastcdr::Cdr& cdr)
+    {
+        cdr << std::string("HelloWorldTopic") << true;
+        cdr << uint16_t(0x03) << true << uint16_t(5) << false << false << false;
+        cdr << false;
+    });
+    dds::xrce::DATAWRITER_Representation datawriter_representation;
+    datawriter_representation.publisher_id(publisher_id);
+    datawriter_representation.representation().binary_representation(datawriter_bin);
+    object_variant.data_writer(datawriter_representation);
+    dds::xrce::ObjectPrefix datawriter_id = {0x00, 0x15};
+    response = client->create(creation_mode, datawriter_id, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    creation_mode.reuse(true);
+    creation_mode.replace(false);
+    response = client->create(creation_mode, datawriter_id, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK_MATCHED, response.status());
+    creation_mode.reuse(false);
+    creation_mode.replace(true);
+
+    /* An unknown topic is refused. */
+    datawriter_representation.representation().binary_representation(serialize([](fastcdr::Cdr& cdr)
+    {
+        cdr << std::string("UnknownTopic") << false;
+    }));
+    object_variant.data_writer(datawriter_representation);
+    response = client->create(creation_mode, {0x00, 0x25}, object_variant);
+    ASSERT_NE(dds::xrce::STATUS_OK, response.status());
+
+    /* Datareader: default QoS, and a truncated representation is refused. */
+    dds::xrce::OBJK_SUBSCRIBER_Representation subscriber_representation;
+    subscriber_representation.participant_id(participant_id);
+    subscriber_representation.representation().string_representation("");
+    object_variant.subscriber(subscriber_representation);
+    dds::xrce::ObjectPrefix subscriber_id = {0x00, 0x14};
+    response = client->create(creation_mode, subscriber_id, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    std::vector<uint8_t> datareader_bin = serialize([](fastcdr::Cdr& cdr)
+    {
+        cdr << std::string("HelloWorldTopic") << false;
+    });
+    dds::xrce::DATAREADER_Representation datareader_representation;
+    datareader_representation.subscriber_id(subscriber_id);
+    datareader_representation.representation().binary_representation(
+                std::vector<uint8_t>(datareader_bin.begin(), datareader_bin.end() - 1));
+    object_variant.data_reader(datareader_representation);
+    response = client->create(creation_mode, {0x00, 0x16}, object_variant);
+    ASSERT_NE(dds::xrce::STATUS_OK, response.status());
+
+    datareader_representation.representation().binary_representation(datareader_bin);
+    object_variant.data_reader(datareader_representation);
+    response = client->create(creation_mode, {0x00, 0x16}, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    /* Participant destruction. */
+    response = client->delete_object(participant_id);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+}
+
+TEST_F(TreeTests, PrewarmedParticipant)
+{
+    std::shared_ptr<ProxyClient> client;
+    ASSERT_NO_FATAL_FAILURE(create_client(client_key_, client));
+
+    ASSERT_FALSE(ParticipantPool::instance().prewarm("unknown_participant", 1));
+    ASSERT_TRUE(ParticipantPool::instance().prewarm("default_xrce_participant", 1));
+    ASSERT_EQ(1u, ParticipantPool::instance().warm_size());
+
+    /* Claimed by a participant of the same profile. */
+    dds::xrce::ObjectVariant object_variant;
+    dds::xrce::OBJK_PARTICIPANT_Representation participant_representation;
+    participant_representation.domain_id(0);
+    participant_representation.representation().object_reference("default_xrce_participant");
+    object_variant.participant(participant_representation);
+    dds::xrce::ResultStatus response = client->create(creation_mode_, {0x00, 0x01}, object_variant);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    Participant* participant = dynamic_cast<Participant*>(client->get_object({0x00, 0x01}));
+    ASSERT_NE(nullptr, participant);
+    fastrtps::Participant* rtps_participant = participant->get_rtps_participant();
+    ASSERT_EQ(1u, ParticipantPool::instance().references(rtps_participant));
+
+    /* And topped up in the background. */
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((1u != ParticipantPool::instance().warm_size()) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, ParticipantPool::instance().warm_size());
+
+    response = client->delete_object({0x00, 0x01});
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_EQ(0u, ParticipantPool::instance().references(rtps_participant));
+
+    ParticipantPool::instance().clear_warm();
+    ASSERT_EQ(0u, ParticipantPool::instance().warm_size());
+}
+
+TEST_F(TreeTests, ParticipantPoolConcurrentAcquire)
+{
+    /* Participants are created outside the pool lock: racing clients still share one. */
+    std::vector<std::future<fastrtps::Participant*>> acquired;
+    for (int i = 0; i < 4; ++i)
+    {
+        acquired.push_back(std::async(std::launch::async, [i]()
+        {
+            fastrtps::ParticipantAttributes attributes;
+            attributes.rtps.builtin.domainId = 0;
+            attributes.rtps.setName(("concurrent_" + std::to_string(i)).c_str());
+            return ParticipantPool::instance().acquire(attributes);
+        }));
+    }
+
+    std::vector<fastrtps::Participant*> participants;
+    for (auto& future : acquired)
+    {
+        participants.push_back(future.get());
+        ASSERT_NE(nullptr, participants.back());
+        ASSERT_EQ(participants.front(), participants.back());
+    }
+    ASSERT_EQ(4u, ParticipantPool::instance().references(participants.front()));
+
+    for (auto participant : participants)
+    {
+        ParticipantPool::instance().release(participant);
+    }
+    ASSERT_EQ(0u, ParticipantPool::instance().references(participants.front()));
+}
+
+TEST_F(TreeTests, RepeatedXMLParsesOnce)
+{
+    /* The second parse comes from the cache, with the same attributes. */
+    const std::string xml = "<dds><participant><rtps><name>cached_participant</name>"
+                            "<builtin><domainId>3</domainId></builtin></rtps></participant></dds>";
+    fastrtps::ParticipantAttributes first;
+    fastrtps::ParticipantAttributes second;
+    ASSERT_TRUE(xmlobjects::parse_participant(xml.c_str(), xml.size(), first));
+    ASSERT_TRUE(xmlobjects::parse_participant(xml.c_str(), xml.size(), second));
+    ASSERT_TRUE(first == second);
+    ASSERT_EQ(3u, second.rtps.builtin.domainId);
+    ASSERT_EQ(std::string("cached_participant"), second.rtps.getName());
+}
+
+/*
+ * Feeds messages to the Processor of a server that is never run, so nothing is sent.
+ */
+class ProcessorTests : public ::testing::Test
+{
+protected:
+    class TestEndPoint : public EndPoint
+    {
+    };
+
+    class TestServer : public Server
+    {
+    public:
+        explicit TestServer(const dds::xrce::ClientKey& client_key) : client_key_(client_key) {}
+
+        Processor& processor() { return *processor_; }
+        void on_create_client(EndPoint*, const dds::xrce::ClientKey&) override {}
+        void on_delete_client(EndPoint*) override {}
+        const dds::xrce::ClientKey get_client_key(EndPoint*) override { return client_key_; }
+        std::unique_ptr<EndPoint> get_source(const dds::xrce::ClientKey&) override
+        {
+            return std::unique_ptr<EndPoint>(new TestEndPoint());
+        }
+
+    private:
+        bool init() override { return true; }
+        bool close() override { return true; }
+        bool recv_message(InputPacket&, int) override { return false; }
+        bool send_message(OutputPacket) override { return true; }
+        int get_error() override { return 0; }
+
+        dds::xrce::ClientKey client_key_;
+    };
+
+    ProcessorTests()
+        : server_(client_key_)
+    {
+        dds::xrce::AGENT_Representation agent_representation;
+        dds::xrce::CLIENT_Representation client_representation;
+        client_representation.xrce_cookie(dds::xrce::XRCE_COOKIE);
+        client_representation.xrce_version(dds::xrce::XRCE_VERSION);
+        client_representation.xrce_vendor_id(vendor_id_);
+        client_representation.client_key(client_key_);
+        client_representation.session_id(session_id_);
+        server_.processor().get_root()->create_client(client_representation, agent_representation);
+        client_ = server_.processor().get_root()->get_client(client_key_);
+    }
+
+    virtual ~ProcessorTests() = default;
+
+    static dds::xrce::CREATE_Payload participant_payload(const dds::xrce::ObjectId& object_id)
+    {
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::OBJK_PARTICIPANT_Representation participant_representation;
+        participant_representation.domain_id(0);
+        participant_representation.representation().object_reference("default_xrce_participant");
+        object_variant.participant(participant_representation);
+        return create_payload(object_id, object_variant);
+    }
+
+    static dds::xrce::CREATE_Payload topic_payload(const dds::xrce::ObjectId& object_id,
+                                                   const dds::xrce::ObjectId& participant_id)
+    {
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::OBJK_TOPIC_Representation topic_representation;
+        topic_representation.participant_id(participant_id);
+        topic_representation.representation().object_reference("shapetype_topic");
+        object_variant.topic(topic_representation);
+        return create_payload(object_id, object_variant);
+    }
+
+    static dds::xrce::CREATE_Payload publisher_payload(const dds::xrce::ObjectId& object_id,
+                                                       const dds::xrce::ObjectId& participant_id)
+    {
+        dds::xrce::ObjectVariant object_variant;
+        dds::xrce::OBJK_PUBLISHER_Representation publisher_representation;
+        publisher_representation.participant_id(participant_id);
+        publisher_representation.representation().string_representation("");
+        object_variant.publisher(publisher_representation);
+        return create_payload(object_id, object_variant);
+    }
+
+    static dds::xrce::CREATE_Payload create_payload(const dds::xrce::ObjectId& object_id,
+                                                    const dds::xrce::ObjectVariant& object_variant)
+    {
+        dds::xrce::CREATE_Payload payload;
+        payload.request_id({{0x00, object_id[1]}});
+        payload.object_id(object_id);
+        payload.object_representation(object_variant);
+        return payload;
+    }
+
+    /*
+     * One message holding a CREATE submessage per payload, in order.
+     */
+    InputPacket create_packet(dds::xrce::StreamId stream_id, uint16_t seq_num,
+                              const std::vector<dds::xrce::CREATE_Payload>& payloads)
+    {
+        dds::xrce::MessageHeader header;
+        header.session_id(session_id_);
+        header.stream_id(stream_id);
+        header.sequence_nr(seq_num);
+        header.client_key(client_key_);
+        OutputMessage output_message(header);
+        for (const auto& payload : payloads)
+        {
+            output_message.append_submessage(dds::xrce::CREATE, payload, dds::xrce::FLAG_REPLACE | 0x01);
+        }
+
+        InputPacket input_packet;
+        input_packet.source = std::make_shared<TestEndPoint>();
+        input_packet.message.reset(new InputMessage(output_message.get_buf(), output_message.get_len()));
+        return input_packet;
+    }
+
+    bool wait_object(const dds::xrce::ObjectId& object_id)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while ((nullptr == client_->get_object(object_id)) && (std::chrono::steady_clock::now() < deadline))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return (nullptr != client_->get_object(object_id));
+    }
+
+    const dds::xrce::ClientKey client_key_      = {{0xE1, 0xE2, 0xE3, 0xE4}};
+    const dds::xrce::XrceVendorId vendor_id_    = {{0x00, 0x01}};
+    const dds::xrce::SessionId session_id_      = 0x01;
+    TestServer server_;
+    std::shared_ptr<ProxyClient> client_;
+};
+
+TEST_F(ProcessorTests, DeferredCreationsKeepOrder)
+{
+    ASSERT_NE(nullptr, client_);
+
+    /* The topic needs the participant created right before it in the same message,
+       and the publisher of the next message needs it too. */
+    server_.processor().process_input_packet(
+                create_packet(0x01, 0, {participant_payload({{0x00, 0x01}}),
+                                        topic_payload({{0x00, 0x22}}, {{0x00, 0x01}})}));
+    server_.processor().process_input_packet(
+                create_packet(0x01, 1, {publisher_payload({{0x00, 0x13}}, {{0x00, 0x01}})}));
+
+    ASSERT_TRUE(wait_object({{0x00, 0x13}}));
+    ASSERT_TRUE(wait_object({{0x00, 0x22}}));
+    ASSERT_NE(nullptr, client_->get_object({{0x00, 0x01}}));
+}
+
+TEST_F(ProcessorTests, SessionStreamIsNotDeferred)
+{
+    ASSERT_NE(nullptr, client_);
+
+    /* A creation in progress on a user stream does not hold the session stream back. */
+    server_.processor().process_input_packet(create_packet(0x01, 0, {participant_payload({{0x00, 0x01}})}));
+    server_.processor().process_input_packet(create_packet(0x00, 0, {participant_payload({{0x00, 0x21}})}));
+    ASSERT_NE(nullptr, client_->get_object({{0x00, 0x21}}));
+
+    ASSERT_TRUE(wait_object({{0x00, 0x01}}));
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
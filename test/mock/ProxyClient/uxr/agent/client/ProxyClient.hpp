@@ -17,6 +17,7 @@
 
 #include <uxr/agent/types/XRCETypes.hpp>
 #include <uxr/agent/client/session/Session.hpp>
+#include <uxr/agent/utils/TokenBucket.hpp>
 
 #include <gmock/gmock.h>
 
@@ -26,7 +27,8 @@ namespace uxr {
 class ProxyClient
 {
 public:
-    explicit ProxyClient(const dds::xrce::CLIENT_Representation&){}
+    explicit ProxyClient(const dds::xrce::CLIENT_Representation&,
+                         const std::shared_ptr<utils::TokenBucket>& = nullptr){}
     ~ProxyClient() = default;
 
     ProxyClient(const ProxyClient&) = delete;
@@ -13,17 +13,33 @@
 // limitations under the License.
 
 #include <uxr/agent/utils/TokenBucket.hpp>
+#include <uxr/agent/utils/Pacer.hpp>
+#include <uxr/agent/scheduler/Executor.hpp>
+#include <uxr/agent/scheduler/TimerWheel.hpp>
+#include <uxr/agent/client/session/Session.hpp>
+#include <uxr/agent/datareader/ContentFilter.hpp>
+#include <uxr/agent/scheduler/OutputScheduler.hpp>
+#include <uxr/agent/config.hpp>
+#include "xmlobjects/ParseCache.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <functional>
 #include <random>
 #include <thread>
+#include <atomic>
+#include <future>
+#include <map>
+#include <cstring>
 
 namespace eprosima {
 namespace uxr {
 namespace testing {
 
 using eprosima::uxr::utils::TokenBucket;
+using eprosima::uxr::utils::Pacer;
+using eprosima::uxr::xmlobjects::ParseCache;
 
 class TokenBucketTests : public ::testing::Test
 {
@@ -73,9 +89,9 @@ TEST_F(TokenBucketTests, NoRateNoBurst)
 
 TEST_F(TokenBucketTests, AdjustedBurst)
 {
-    const unsigned int min_rate = 64000;
-    const unsigned int rate     = (unsigned int) (min_rate * 0.5);
-    TokenBucket bucket{rate, 10};
+    // The bucket starts with one second of tokens, and fills up to the burst.
+    const unsigned int rate = 32000;
+    TokenBucket bucket{rate, 2 * rate};
     ASSERT_TRUE(bucket.get_tokens(rate));
     ASSERT_FALSE(bucket.get_tokens(10));
     ASSERT_TRUE(bucket.get_tokens(rate * sleep_thread(2100)));
@@ -85,17 +101,19 @@ TEST_F(TokenBucketTests, AdjustedBurst)
     ASSERT_FALSE(bucket.get_tokens(rate));
 }
 
-TEST_F(TokenBucketTests, LimitToUDPBucket)
+TEST_F(TokenBucketTests, OversizedRequest)
 {
-    const int udp_size = 64000;
-    TokenBucket bucket{0, 1};
-    ASSERT_FALSE(bucket.get_tokens(udp_size + 1));
-    ASSERT_TRUE(bucket.get_tokens(udp_size));
-    ASSERT_FALSE(bucket.get_tokens(udp_size * sleep_thread(2100)));
-    ASSERT_TRUE(bucket.get_tokens(udp_size));
-    ASSERT_FALSE(bucket.get_tokens(10));
-    ASSERT_TRUE(bucket.get_tokens(udp_size * sleep_thread(1100)));
-    ASSERT_FALSE(bucket.get_tokens(10));
+    // A request larger than the burst goes once the bucket is full, and is charged in full.
+    const size_t rate = 1000;
+    TokenBucket bucket{rate, 100};
+    ASSERT_EQ(100u, bucket.capacity());
+    ASSERT_TRUE(bucket.get_tokens(2500));
+    ASSERT_FALSE(bucket.get_tokens(1));
+    ASSERT_LE(2400, bucket.time_to_tokens(2500).count());
+    ASSERT_GE(2500, bucket.time_to_tokens(2500).count());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2600));
+    ASSERT_TRUE(bucket.get_tokens(50));
+    ASSERT_FALSE(bucket.get_tokens(60));
 }
 
 TEST_F(TokenBucketTests, RateMeassure)
@@ -125,6 +143,859 @@ TEST_F(TokenBucketTests, RateMeassure)
     ASSERT_EQ(requested_tokens / bunch_size, reading_counter);
 }
 
+TEST_F(TokenBucketTests, TimeToTokens)
+{
+    const size_t rate = 1000;
+    TokenBucket bucket{rate, 0};
+    ASSERT_EQ(0, bucket.time_to_tokens(rate).count());
+    ASSERT_TRUE(bucket.get_tokens(rate));
+    ASSERT_LE(400, bucket.time_to_tokens(rate / 2).count());
+    ASSERT_GE(500, bucket.time_to_tokens(rate / 2).count());
+}
+
+TEST_F(TokenBucketTests, FrequentPollingRefill)
+{
+    // Polling faster than one token per millisecond does not lose the partial refills.
+    const size_t rate = 500;
+    TokenBucket bucket{rate, 0};
+    ASSERT_TRUE(bucket.get_tokens(rate));
+    size_t taken = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000))
+    {
+        if (bucket.get_tokens(1))
+        {
+            ++taken;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    ASSERT_LE(rate - 25, taken);
+    ASSERT_GE(rate + 5, taken);
+}
+
+TEST_F(TokenBucketTests, Hierarchy)
+{
+    // Reader -> client -> link, as the agent builds them.
+    auto link = std::make_shared<TokenBucket>(100, 0);
+    auto client = std::make_shared<TokenBucket>(80, 0, link);
+    auto other_client = std::make_shared<TokenBucket>(80, 0, link);
+    TokenBucket reader{50, 0, client};
+    TokenBucket other_reader{50, 0, client};
+    ASSERT_EQ(client, reader.parent());
+    ASSERT_EQ(link, client->parent());
+
+    // The client budget is shared by its readers, and the link budget by the clients.
+    ASSERT_TRUE(reader.get_tokens(50));
+    ASSERT_FALSE(other_reader.get_tokens(40));
+    ASSERT_FALSE(other_client->get_tokens(60));
+    ASSERT_TRUE(other_client->get_tokens(50));
+    ASSERT_LE(300, other_reader.time_to_tokens(40).count());
+
+    // Tokens refused up the hierarchy were given back, and refunds go all the way up.
+    reader.refund_tokens(50);
+    ASSERT_TRUE(other_reader.get_tokens(40));
+    ASSERT_FALSE(other_client->get_tokens(20));
+    ASSERT_TRUE(other_client->get_tokens(10));
+}
+
+TEST_F(TokenBucketTests, ConcurrentGetTokens)
+{
+    const size_t rate = 1000;
+    TokenBucket bucket{rate, 0};
+    std::atomic<size_t> taken{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int j = 0; j < 10000; ++j)
+            {
+                if (bucket.get_tokens(1))
+                {
+                    ++taken;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_LE(rate, taken);
+    ASSERT_GE(rate + 50, taken);
+}
+
+TEST(ExecutorTests, PostRunsAllTasks)
+{
+    const int tasks = 1000;
+    Executor executor{4};
+    ASSERT_EQ(4u, executor.thread_count());
+
+    std::atomic<int> counter{0};
+    std::promise<void> done;
+    for (int i = 0; i < tasks; ++i)
+    {
+        executor.post([&]()
+        {
+            if (tasks == ++counter)
+            {
+                done.set_value();
+            }
+        });
+    }
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+}
+
+TEST(ExecutorTests, TimersFireInDeadlineOrder)
+{
+    Executor executor{1};
+    std::mutex mtx;
+    std::vector<int> order;
+    std::promise<void> done;
+    auto start = std::chrono::steady_clock::now();
+
+    executor.schedule(std::chrono::milliseconds(60), [&]()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        order.push_back(2);
+        done.set_value();
+    });
+    executor.schedule(std::chrono::milliseconds(20), [&]()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        order.push_back(1);
+    });
+
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+    ASSERT_LE(60, std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start).count());
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ((std::vector<int>{1, 2}), order);
+}
+
+TEST(ExecutorTests, CancelledTimerDoesNotFire)
+{
+    Executor executor{1};
+    std::atomic<bool> fired{false};
+    Executor::TimerId timer_id = executor.schedule(std::chrono::milliseconds(50), [&]() { fired = true; });
+    ASSERT_TRUE(executor.cancel(timer_id));
+    ASSERT_FALSE(executor.cancel(timer_id));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(fired);
+}
+
+TEST(TimerWheelTests, FiresAtExpiryAcrossLevels)
+{
+    TimerWheel wheel{10};
+    std::vector<TimerWheel::Tick> fired;
+    const std::vector<TimerWheel::Tick> expiries{11, 64, 73, 4096, 4200, 300000, 20000000};
+    for (size_t i = 0; i < expiries.size(); ++i)
+    {
+        TimerWheel::Tick expiry = expiries[expiries.size() - 1 - i];
+        wheel.schedule(i, expiry, [&fired, &wheel, expiry]()
+        {
+            fired.push_back(expiry);
+            ASSERT_EQ(expiry, wheel.current());
+        });
+    }
+    ASSERT_EQ(expiries.size(), wheel.size());
+
+    std::vector<TimerWheel::Task> expired;
+    while (!wheel.empty())
+    {
+        TimerWheel::Tick next = wheel.next_expiry();
+        ASSERT_LT(wheel.current(), next);
+        wheel.advance(next - 1, expired);
+        ASSERT_TRUE(expired.empty());
+        wheel.advance(next, expired);
+        for (auto& task : expired)
+        {
+            task();
+        }
+        expired.clear();
+    }
+    ASSERT_EQ(expiries, fired);
+    ASSERT_EQ(TimerWheel::never, wheel.next_expiry());
+}
+
+TEST(TimerWheelTests, CancelAndReschedule)
+{
+    TimerWheel wheel;
+    std::vector<int> fired;
+    wheel.schedule(1, 100, [&]() { fired.push_back(1); });
+    wheel.schedule(2, 50, [&]() { fired.push_back(2); });
+    wheel.schedule(3, 5000, [&]() { fired.push_back(3); });
+    ASSERT_TRUE(wheel.cancel(2));
+    ASSERT_FALSE(wheel.cancel(2));
+    wheel.schedule(3, 20, [&]() { fired.push_back(3); });
+    ASSERT_EQ(2u, wheel.size());
+
+    std::vector<TimerWheel::Task> expired;
+    wheel.advance(10000, expired);
+    for (auto& task : expired)
+    {
+        task();
+    }
+    ASSERT_EQ((std::vector<int>{3, 1}), fired);
+    ASSERT_TRUE(wheel.empty());
+    ASSERT_EQ(10000u, wheel.current());
+}
+
+TEST(TimerWheelTests, OverdueTimerFiresOnNextTick)
+{
+    TimerWheel wheel{1000};
+    wheel.schedule(1, 10, []() {});
+    ASSERT_EQ(1001u, wheel.next_expiry());
+    std::vector<TimerWheel::Task> expired;
+    wheel.advance(1001, expired);
+    ASSERT_EQ(1u, expired.size());
+}
+
+TEST(RttEstimatorTests, FollowsSamples)
+{
+    RttEstimator rtt;
+    ASSERT_FALSE(rtt.has_sample());
+    ASSERT_EQ(std::chrono::milliseconds(HEARTBEAT_PERIOD), rtt.rto());
+
+    /* First sample: SRTT = R, RTTVAR = R / 2. */
+    rtt.add_sample(std::chrono::milliseconds(40));
+    ASSERT_TRUE(rtt.has_sample());
+    ASSERT_EQ(std::chrono::microseconds(40000), rtt.srtt());
+    ASSERT_EQ(std::chrono::microseconds(20000), rtt.rttvar());
+    ASSERT_EQ(std::chrono::milliseconds(120), rtt.rto());
+
+    /* A steady RTT makes the variance, and so the timeout, converge. */
+    for (int i = 0; i < 100; ++i)
+    {
+        rtt.add_sample(std::chrono::milliseconds(40));
+    }
+    ASSERT_EQ(std::chrono::microseconds(40000), rtt.srtt());
+    ASSERT_EQ(std::chrono::milliseconds(41), rtt.rto());
+}
+
+TEST(RttEstimatorTests, TimeoutIsBounded)
+{
+    RttEstimator fast;
+    fast.add_sample(std::chrono::microseconds(100));
+    ASSERT_EQ(std::chrono::milliseconds(MIN_HEARTBEAT_PERIOD), fast.rto());
+
+    RttEstimator slow;
+    slow.add_sample(std::chrono::seconds(60));
+    ASSERT_EQ(std::chrono::milliseconds(MAX_HEARTBEAT_PERIOD), slow.rto());
+}
+
+TEST(SessionTests, HeartbeatTiming)
+{
+    Session session;
+    const dds::xrce::StreamId stream_id = 0x80;
+    auto now = std::chrono::steady_clock::now();
+    ASSERT_EQ(std::chrono::milliseconds(HEARTBEAT_PERIOD), session.heartbeat_period(stream_id));
+
+    /* Answered HEARTBEAT: RTT sample. */
+    session.on_heartbeat_sent(stream_id, now);
+    session.on_acknack_received(stream_id, now + std::chrono::milliseconds(50));
+    ASSERT_EQ(std::chrono::microseconds(50000), session.get_rtt().srtt());
+    std::chrono::milliseconds rto = session.get_rtt().rto();
+    ASSERT_EQ(rto, session.heartbeat_period(stream_id));
+
+    /* Unanswered HEARTBEATs back off. */
+    session.on_heartbeat_sent(stream_id, now);
+    ASSERT_EQ(rto, session.heartbeat_period(stream_id));
+    session.on_heartbeat_sent(stream_id, now);
+    ASSERT_EQ(rto * 2, session.heartbeat_period(stream_id));
+    session.on_heartbeat_sent(stream_id, now);
+    ASSERT_EQ(rto * 4, session.heartbeat_period(stream_id));
+
+    /* An ambiguous ACKNACK resets the backoff but gives no sample. */
+    session.on_acknack_received(stream_id, now + std::chrono::seconds(5));
+    ASSERT_EQ(std::chrono::microseconds(50000), session.get_rtt().srtt());
+    ASSERT_EQ(rto, session.heartbeat_period(stream_id));
+}
+
+TEST(SessionTests, RetransmissionHoldoff)
+{
+    Session session;
+    const dds::xrce::StreamId stream_id = 0x80;
+    dds::xrce::MessageHeader header;
+    header.stream_id(stream_id);
+    OutputMessagePtr message(new OutputMessage(header));
+    ASSERT_TRUE(session.push_output_message(stream_id, message));
+    const SeqNum seq_num = session.get_first_unacked_seq_nr(stream_id);
+
+    /* The original transmission is still within the holdoff. */
+    auto now = std::chrono::steady_clock::now();
+    OutputMessagePtr retransmission;
+    ASSERT_FALSE(session.get_retransmission(stream_id, seq_num, now, retransmission));
+
+    /* One copy per holdoff, however many NACKs arrive. */
+    now += std::chrono::milliseconds(MIN_HEARTBEAT_PERIOD);
+    ASSERT_TRUE(session.get_retransmission(stream_id, seq_num, now, retransmission));
+    ASSERT_EQ(message, retransmission);
+    ASSERT_FALSE(session.get_retransmission(stream_id, seq_num, now, retransmission));
+
+    /* Once measured, the holdoff is the smoothed RTT. */
+    session.on_heartbeat_sent(stream_id, now);
+    session.on_acknack_received(stream_id, now + std::chrono::milliseconds(100));
+    ASSERT_FALSE(session.get_retransmission(stream_id, seq_num, now + std::chrono::milliseconds(50), retransmission));
+    ASSERT_TRUE(session.get_retransmission(stream_id, seq_num, now + std::chrono::milliseconds(100), retransmission));
+
+    /* A message waits at most once in the output scheduler. */
+    ASSERT_TRUE(message->mark_queued());
+    ASSERT_FALSE(message->mark_queued());
+    message->mark_sent();
+    ASSERT_TRUE(message->mark_queued());
+}
+
+TEST(CongestionControlTests, SlowStartThenAvoidance)
+{
+    CongestionControl cc;
+    ASSERT_EQ(2u, cc.window());
+
+    /* Slow start: one more message per acknowledged message. */
+    cc.on_ack(2, SeqNum(2));
+    ASSERT_EQ(4u, cc.window());
+
+    /* Congestion avoidance past the threshold: one more message per window. */
+    cc.on_loss(SeqNum(2), SeqNum(5));
+    ASSERT_EQ(2u, cc.window());
+    ASSERT_EQ(2u, cc.threshold());
+    cc.on_ack(1, SeqNum(7));
+    ASSERT_EQ(2u, cc.window());
+    cc.on_ack(1, SeqNum(8));
+    ASSERT_EQ(3u, cc.window());
+
+    /* Never above the stream depth. */
+    cc.on_ack(60000, SeqNum(9));
+    ASSERT_EQ(RELIABLE_STREAM_DEPTH, cc.window());
+}
+
+TEST(CongestionControlTests, LossHalvesOncePerWindow)
+{
+    CongestionControl cc;
+    cc.on_ack(6, SeqNum(6));
+    ASSERT_EQ(8u, cc.window());
+
+    /* Several NACKs for the same window of data: a single decrease. */
+    cc.on_loss(SeqNum(6), SeqNum(13));
+    cc.on_loss(SeqNum(8), SeqNum(13));
+    cc.on_loss(SeqNum(13), SeqNum(13));
+    ASSERT_EQ(4u, cc.window());
+
+    /* Data sent after the decrease is a new window. */
+    cc.on_loss(SeqNum(14), SeqNum(16));
+    ASSERT_EQ(2u, cc.window());
+}
+
+TEST(CongestionControlTests, TimeoutCollapses)
+{
+    CongestionControl cc;
+    cc.on_ack(6, SeqNum(6));
+    cc.on_timeout(SeqNum(13));
+    ASSERT_EQ(1u, cc.window());
+    ASSERT_EQ(4u, cc.threshold());
+    cc.on_timeout(SeqNum(13));
+    ASSERT_EQ(4u, cc.threshold());
+
+    /* Slow start up to the threshold once the stream recovers. */
+    cc.on_ack(3, SeqNum(17));
+    ASSERT_EQ(4u, cc.window());
+}
+
+TEST(SessionTests, CongestionWindowGatesOutput)
+{
+    Session session;
+    const dds::xrce::StreamId stream_id = 0x80;
+    OutputMessagePtr message;
+
+    /* Disabled: only the stream depth limits the output. */
+    for (uint16_t i = 0; i < RELIABLE_STREAM_DEPTH; ++i)
+    {
+        ASSERT_FALSE(session.output_window_full(stream_id));
+        ASSERT_TRUE(session.push_output_message(stream_id, message));
+    }
+    ASSERT_TRUE(session.output_window_full(stream_id));
+    session.reset();
+
+    /* Enabled: the congestion window limits the messages in flight. */
+    session.set_congestion_control(true);
+    ASSERT_EQ(2u, session.congestion_window(stream_id));
+    ASSERT_TRUE(session.push_output_message(stream_id, message));
+    ASSERT_TRUE(session.push_output_message(stream_id, message));
+    ASSERT_TRUE(session.output_window_full(stream_id));
+
+    /* Acknowledging them opens the window (slow start). */
+    session.update_from_acknack(stream_id, SeqNum(2));
+    ASSERT_EQ(4u, session.congestion_window(stream_id));
+    ASSERT_FALSE(session.output_window_full(stream_id));
+
+    /* A NACK halves it. */
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(session.push_output_message(stream_id, message));
+    }
+    session.update_from_acknack(stream_id, SeqNum(2), {{0x00, 0x01}});
+    ASSERT_EQ(2u, session.congestion_window(stream_id));
+    ASSERT_TRUE(session.output_window_full(stream_id));
+}
+
+/* CDR (little endian) for {int32 id; string name; float64 value}. */
+std::vector<uint8_t> serialize_sample(int32_t id, const std::string& name, double value)
+{
+    std::vector<uint8_t> buffer(4);
+    std::memcpy(buffer.data(), &id, sizeof(id));
+    uint32_t length = uint32_t(name.size() + 1);
+    buffer.resize(buffer.size() + 4);
+    std::memcpy(buffer.data() + 4, &length, sizeof(length));
+    buffer.insert(buffer.end(), name.begin(), name.end());
+    buffer.push_back(0);
+    buffer.resize((buffer.size() + 7) & ~size_t(7));
+    size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(value));
+    std::memcpy(buffer.data() + offset, &value, sizeof(value));
+    return buffer;
+}
+
+TEST(ContentFilterTests, Comparisons)
+{
+    ContentFilter filter;
+    ASSERT_TRUE(filter.compile("{int32 id; string name; float64 value} value > 25.5 AND name = 'temp'"));
+    std::vector<uint8_t> sample = serialize_sample(1, "temp", 30.0);
+    ASSERT_TRUE(filter.evaluate(sample.data(), sample.size()));
+    sample = serialize_sample(1, "temp", 20.0);
+    ASSERT_FALSE(filter.evaluate(sample.data(), sample.size()));
+    sample = serialize_sample(1, "humidity", 30.0);
+    ASSERT_FALSE(filter.evaluate(sample.data(), sample.size()));
+}
+
+TEST(ContentFilterTests, LogicalOperators)
+{
+    ContentFilter filter;
+    ASSERT_TRUE(filter.compile("{int32 id} NOT (id = 3 OR id >= 10) and id <> -1"));
+    for (int32_t id : {-1, 0, 3, 5, 10, 11})
+    {
+        std::vector<uint8_t> sample = serialize_sample(id, "", 0.0);
+        ASSERT_EQ(!(id == 3 || id >= 10) && id != -1, filter.evaluate(sample.data(), sample.size()));
+    }
+}
+
+TEST(ContentFilterTests, TruncatedSample)
+{
+    ContentFilter filter;
+    ASSERT_TRUE(filter.compile("{int32 id; string name; float64 value} value = 1"));
+    std::vector<uint8_t> sample = serialize_sample(1, "name", 1.0);
+    ASSERT_TRUE(filter.evaluate(sample.data(), sample.size()));
+    ASSERT_FALSE(filter.evaluate(sample.data(), sample.size() - 1));
+    ASSERT_FALSE(filter.evaluate(sample.data(), 6));
+}
+
+TEST(ContentFilterTests, InvalidExpressions)
+{
+    ContentFilter filter;
+    ASSERT_FALSE(filter.compile(""));
+    ASSERT_FALSE(filter.compile("{int32 id} other = 1"));
+    ASSERT_FALSE(filter.compile("{int128 id} id = 1"));
+    ASSERT_FALSE(filter.compile("{int32 id} id = 1 AND"));
+    ASSERT_FALSE(filter.compile("{int32 id} (id = 1"));
+    ASSERT_FALSE(filter.compile("{int32 id; int32 id} id = 1"));
+    ASSERT_TRUE(filter.empty());
+}
+
+OutputPacket make_output_packet(uint8_t stream_id, uint16_t seq_num, std::shared_ptr<TokenBucket> budget)
+{
+    dds::xrce::MessageHeader header;
+    header.stream_id(stream_id);
+    header.sequence_nr(seq_num);
+    OutputPacket output_packet;
+    output_packet.message = std::make_shared<OutputMessage>(header);
+    output_packet.budget = std::move(budget);
+    return output_packet;
+}
+
+TEST(OutputSchedulerTests, HigherPriorityFirst)
+{
+    OutputScheduler scheduler;
+    scheduler.init();
+    const uint8_t streams[] = {0x01, 0x80, 0x00};
+    for (uint8_t stream_id : streams)
+    {
+        scheduler.push(make_output_packet(stream_id, 0, nullptr), OutputScheduler::get_priority(stream_id));
+    }
+
+    OutputPacket output_packet;
+    for (uint8_t stream_id : {0x00, 0x80, 0x01})
+    {
+        ASSERT_TRUE(scheduler.pop(output_packet));
+        ASSERT_EQ(stream_id, output_packet.message->get_buf()[1]);
+    }
+    scheduler.deinit();
+}
+
+TEST(OutputSchedulerTests, ThrottledClientDoesNotBlockOthers)
+{
+    OutputScheduler scheduler;
+    scheduler.init();
+    size_t message_size = make_output_packet(0x01, 0, nullptr).message->get_len();
+    auto budget = std::make_shared<TokenBucket>(message_size, 0);
+
+    /* The first packet drains the budget, the second one waits for it. */
+    scheduler.push(make_output_packet(0x01, 1, budget), OutputScheduler::BEST_EFFORT_PRIORITY);
+    scheduler.push(make_output_packet(0x01, 2, budget), OutputScheduler::BEST_EFFORT_PRIORITY);
+    scheduler.push(make_output_packet(0x01, 3, nullptr), OutputScheduler::BEST_EFFORT_PRIORITY);
+
+    std::vector<uint8_t> order;
+    OutputPacket output_packet;
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(scheduler.pop(output_packet));
+        order.push_back(output_packet.message->get_buf()[2]);
+    }
+    ASSERT_EQ(2, order.back());
+    scheduler.deinit();
+    ASSERT_FALSE(scheduler.pop(output_packet));
+}
+
+TEST(OutputSchedulerTests, PacedDestinationIsSmoothed)
+{
+    OutputScheduler scheduler;
+    scheduler.init();
+    size_t message_size = make_output_packet(0x01, 0, nullptr).message->get_len();
+    auto pacer = std::make_shared<Pacer>(message_size * 50, message_size); // One packet every 20 ms.
+    for (uint8_t i = 1; i <= 3; ++i)
+    {
+        OutputPacket output_packet = make_output_packet(0x01, i, nullptr);
+        output_packet.pacer = pacer;
+        scheduler.push(std::move(output_packet), OutputScheduler::BEST_EFFORT_PRIORITY);
+    }
+    scheduler.push(make_output_packet(0x01, 4, nullptr), OutputScheduler::BEST_EFFORT_PRIORITY);
+
+    /* The unpaced destination goes while the pacer holds the burst back. */
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> order;
+    OutputPacket output_packet;
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(scheduler.pop(output_packet));
+        order.push_back(output_packet.message->get_buf()[2]);
+    }
+    ASSERT_EQ((std::vector<uint8_t>{1, 4, 2, 3}), order);
+    ASSERT_LE(39, std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start).count());
+    scheduler.deinit();
+}
+
+TEST(OutputSchedulerTests, FlowDropsOldestBestEffort)
+{
+    OutputScheduler scheduler;
+    scheduler.init();
+    scheduler.push(make_output_packet(0x80, 0, nullptr), OutputScheduler::RELIABLE_PRIORITY);
+    for (uint16_t i = 1; i <= OUTPUT_QUEUE_SIZE + 1; ++i)
+    {
+        scheduler.push(make_output_packet(0x01, i, nullptr), OutputScheduler::BEST_EFFORT_PRIORITY);
+    }
+
+    /* The reliable packet is kept, the two oldest best-effort ones are not. */
+    OutputPacket output_packet;
+    ASSERT_TRUE(scheduler.pop(output_packet));
+    ASSERT_EQ(0x80, output_packet.message->get_buf()[1]);
+    for (uint16_t i = 3; i <= OUTPUT_QUEUE_SIZE + 1; ++i)
+    {
+        ASSERT_TRUE(scheduler.pop(output_packet));
+        ASSERT_EQ(uint8_t(i), output_packet.message->get_buf()[2]);
+    }
+    scheduler.deinit();
+    ASSERT_FALSE(scheduler.pop(output_packet));
+}
+
+TEST(ParseCacheTests, RepeatedStringHits)
+{
+    ParseCache<std::string> cache(XML_CACHE_SIZE);
+    const std::string xml = "<dds><participant><rtps><name>a</name></rtps></participant></dds>";
+    std::size_t hash = std::hash<std::string>()(xml);
+    std::string attributes;
+    ASSERT_FALSE(cache.find(xml, hash, attributes));
+    cache.insert(xml, hash, "parsed");
+
+    for (int i = 0; i < 2; ++i)
+    {
+        attributes.clear();
+        ASSERT_TRUE(cache.find(xml, hash, attributes));
+        ASSERT_EQ("parsed", attributes);
+    }
+    ASSERT_EQ(1u, cache.size());
+}
+
+TEST(ParseCacheTests, EvictsLeastRecentlyUsed)
+{
+    /* The configured size, unless too small to have a least recently used entry. */
+    const int capacity = std::max(int(XML_CACHE_SIZE), 2);
+    ParseCache<int> cache(capacity);
+    for (int i = 0; i < capacity; ++i)
+    {
+        cache.insert(std::to_string(i), std::hash<std::string>()(std::to_string(i)), i);
+    }
+
+    /* The first entry is used again, so the second one is the least recently used. */
+    int attributes;
+    ASSERT_TRUE(cache.find("0", std::hash<std::string>()("0"), attributes));
+    const std::string overflow = std::to_string(capacity);
+    cache.insert(overflow, std::hash<std::string>()(overflow), capacity);
+
+    ASSERT_EQ(size_t(capacity), cache.size());
+    ASSERT_TRUE(cache.find("0", std::hash<std::string>()("0"), attributes));
+    ASSERT_EQ(0, attributes);
+    ASSERT_FALSE(cache.find("1", std::hash<std::string>()("1"), attributes));
+    ASSERT_TRUE(cache.find(overflow, std::hash<std::string>()(overflow), attributes));
+    ASSERT_EQ(capacity, attributes);
+}
+
+TEST(ParseCacheTests, CollidingHashes)
+{
+    /* Different strings forced onto the same hash keep their own attributes. */
+    ParseCache<int> cache(2);
+    const std::size_t hash = 42;
+    cache.insert("first", hash, 1);
+    cache.insert("second", hash, 2);
+
+    int attributes;
+    ASSERT_TRUE(cache.find("first", hash, attributes));
+    ASSERT_EQ(1, attributes);
+    ASSERT_TRUE(cache.find("second", hash, attributes));
+    ASSERT_EQ(2, attributes);
+    ASSERT_FALSE(cache.find("third", hash, attributes));
+
+    /* Evicting one of them leaves the other reachable. */
+    cache.insert("third", hash, 3);
+    ASSERT_FALSE(cache.find("first", hash, attributes));
+    ASSERT_TRUE(cache.find("second", hash, attributes));
+    ASSERT_EQ(2, attributes);
+    ASSERT_TRUE(cache.find("third", hash, attributes));
+    ASSERT_EQ(3, attributes);
+}
+
+TEST(PacerTests, SpacesPackets)
+{
+    auto now = std::chrono::steady_clock::now();
+    Pacer pacer(1000, 100);
+    ASSERT_EQ(1000u, pacer.rate());
+
+    /* The burst goes at once, then one packet per emission time. */
+    ASSERT_EQ(std::chrono::microseconds(0), pacer.delay(100, now));
+    pacer.on_sent(100, now);
+    ASSERT_EQ(std::chrono::microseconds(100000), pacer.delay(100, now));
+    ASSERT_EQ(std::chrono::microseconds(0), pacer.delay(100, now + std::chrono::milliseconds(100)));
+
+    /* Idle time is not saved up beyond the burst. */
+    now += std::chrono::seconds(10);
+    pacer.on_sent(100, now);
+    ASSERT_EQ(std::chrono::microseconds(100000), pacer.delay(100, now));
+}
+
+/*
+ * Receiving side of the FEC_PARITY submessage, as a client implements it: it rebuilds the message
+ * of a group that got lost, provided it is the only one missing.
+ */
+class FecDecoder
+{
+public:
+    static bool recover(const std::vector<uint8_t>& payload,
+                        const std::map<uint16_t, std::vector<uint8_t>>& received,
+                        uint16_t& seq_num,
+                        std::vector<uint8_t>& message);
+};
+
+bool FecDecoder::recover(const std::vector<uint8_t>& payload,
+                         const std::map<uint16_t, std::vector<uint8_t>>& received,
+                         uint16_t& seq_num,
+                         std::vector<uint8_t>& message)
+{
+    if (FEC_PARITY_HEADER_SIZE > payload.size())
+    {
+        return false;
+    }
+    SeqNum first = SeqNum(uint16_t(payload[0] | (payload[1] << 8)));
+    uint8_t count = payload[2];
+    uint16_t length = uint16_t(payload[4] | (payload[5] << 8));
+    message.assign(payload.begin() + FEC_PARITY_HEADER_SIZE, payload.end());
+
+    uint8_t missing = 0;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        SeqNum current = first + int(i);
+        auto it = received.find(current);
+        if (received.end() == it)
+        {
+            seq_num = current;
+            ++missing;
+            continue;
+        }
+        if (message.size() < it->second.size())
+        {
+            return false;
+        }
+        for (size_t j = 0; j < it->second.size(); ++j)
+        {
+            message[j] ^= it->second[j];
+        }
+        length ^= uint16_t(it->second.size());
+    }
+
+    bool rv = (1 == missing) && (length <= message.size());
+    if (rv)
+    {
+        message.resize(length);
+    }
+    return rv;
+}
+
+TEST(FecTests, RecoversSingleLoss)
+{
+    FecEncoder encoder;
+    encoder.set_group_size(3);
+    std::vector<std::vector<uint8_t>> messages{{1, 2, 3, 4, 5}, {6, 7}, {8, 9, 10}};
+    std::vector<uint8_t> parity;
+    ASSERT_FALSE(encoder.add_message(SeqNum(0xFFFF), messages[0].data(), messages[0].size(), parity));
+    ASSERT_FALSE(encoder.add_message(SeqNum(0), messages[1].data(), messages[1].size(), parity));
+    ASSERT_TRUE(encoder.add_message(SeqNum(1), messages[2].data(), messages[2].size(), parity));
+    ASSERT_EQ(FEC_PARITY_HEADER_SIZE + 5, parity.size());
+
+    /* Any single message of the group, across the sequence wrap. */
+    uint16_t seq_nums[] = {0xFFFF, 0, 1};
+    for (size_t lost = 0; lost < messages.size(); ++lost)
+    {
+        std::map<uint16_t, std::vector<uint8_t>> received;
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            if (i != lost)
+            {
+                received[seq_nums[i]] = messages[i];
+            }
+        }
+        uint16_t seq_num;
+        std::vector<uint8_t> recovered;
+        ASSERT_TRUE(FecDecoder::recover(parity, received, seq_num, recovered));
+        ASSERT_EQ(seq_nums[lost], seq_num);
+        ASSERT_EQ(messages[lost], recovered);
+    }
+
+    /* Two losses are beyond XOR parity. */
+    std::map<uint16_t, std::vector<uint8_t>> received{{0, messages[1]}};
+    uint16_t seq_num;
+    std::vector<uint8_t> recovered;
+    ASSERT_FALSE(FecDecoder::recover(parity, received, seq_num, recovered));
+}
+
+TEST(FecTests, LossInjection)
+{
+    /* 2000 messages through a link dropping 10% of the packets, parity included. */
+    const uint8_t group_size = 4;
+    const int message_count = 2000;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> length(8, 64);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::bernoulli_distribution drop(0.1);
+
+    FecEncoder encoder;
+    encoder.set_group_size(group_size);
+    std::vector<std::vector<uint8_t>> sent;
+    std::map<uint16_t, std::vector<uint8_t>> received;
+    int lost = 0, recovered_count = 0;
+    for (int i = 0; i < message_count; ++i)
+    {
+        std::vector<uint8_t> message(size_t(length(generator)));
+        for (auto& b : message)
+        {
+            b = uint8_t(byte(generator));
+        }
+        sent.push_back(message);
+        if (drop(generator))
+        {
+            ++lost;
+        }
+        else
+        {
+            received[uint16_t(i)] = message;
+        }
+
+        std::vector<uint8_t> parity;
+        if (encoder.add_message(SeqNum(i), message.data(), message.size(), parity) && !drop(generator))
+        {
+            uint16_t seq_num;
+            std::vector<uint8_t> recovered;
+            if (FecDecoder::recover(parity, received, seq_num, recovered))
+            {
+                ASSERT_EQ(sent[seq_num], recovered);
+                received[seq_num] = recovered;
+                ++recovered_count;
+            }
+        }
+    }
+
+    /* Without FEC every loss costs a round trip; with K = 4 roughly two thirds of them are repaired
+       in place (the other three messages and the parity must arrive), for 25% more traffic. */
+    ASSERT_LT(150, lost);
+    ASSERT_LT(lost / 2, recovered_count);
+    ASSERT_EQ(size_t(message_count - lost + recovered_count), received.size());
+}
+
+TEST(SessionTests, FecParityPerGroup)
+{
+    Session session;
+    session.set_fec_group(2);
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<uint8_t> parity;
+    for (uint16_t i = 0; i < 4; ++i)
+    {
+        dds::xrce::MessageHeader header;
+        header.session_id(0x81);
+        header.stream_id(0x80);
+        header.sequence_nr(i);
+        OutputMessagePtr output_message(new OutputMessage(header));
+        messages.emplace_back(output_message->get_buf(), output_message->get_buf() + output_message->get_len());
+        ASSERT_TRUE(session.push_output_message(0x80, output_message));
+        ASSERT_EQ(1 == (i % 2), session.take_fec_parity(0x80, parity));
+    }
+
+    /* The last parity covers messages 2 and 3. */
+    std::map<uint16_t, std::vector<uint8_t>> received{{3, messages[3]}};
+    uint16_t seq_num;
+    std::vector<uint8_t> recovered;
+    ASSERT_TRUE(FecDecoder::recover(parity, received, seq_num, recovered));
+    ASSERT_EQ(2, seq_num);
+    ASSERT_EQ(messages[2], recovered);
+
+    /* Best-effort streams carry no parity. */
+    OutputMessagePtr output_message;
+    ASSERT_TRUE(session.push_output_message(0x01, output_message));
+    ASSERT_FALSE(session.take_fec_parity(0x01, parity));
+}
+
+TEST(SessionTests, FecParityFitsFullMessage)
+{
+    Session session;
+    session.set_fec_group(1);
+    ASSERT_EQ(OutputMessage::get_max_payload_size(), session.max_payload_size(0x01));
+    ASSERT_GT(OutputMessage::get_max_payload_size(), session.max_payload_size(0x80));
+
+    /* The parity of the largest message of a FEC stream still fits in one message. */
+    dds::xrce::MessageHeader header;
+    header.session_id(0x01);
+    header.stream_id(0x80);
+    header.sequence_nr(0);
+    header.client_key({{0xAA, 0xBB, 0xCC, 0xDD}});
+    OutputMessagePtr output_message(new OutputMessage(header));
+    std::vector<uint8_t> payload(session.max_payload_size(0x80), 0xAB);
+    ASSERT_TRUE(output_message->append_raw_submessage(dds::xrce::DATA, payload));
+    ASSERT_TRUE(session.push_output_message(0x80, output_message));
+
+    std::vector<uint8_t> parity;
+    ASSERT_TRUE(session.take_fec_parity(0x80, parity));
+    header.stream_id(0x00);
+    header.sequence_nr(0x80);
+    OutputMessage parity_message(header);
+    ASSERT_TRUE(parity_message.append_raw_submessage(FEC_PARITY_SUBMESSAGE_ID, parity));
+    ASSERT_EQ(OutputMessage::get_mtu_size(), parity_message.get_len());
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
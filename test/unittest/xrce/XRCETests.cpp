@@ -190,6 +190,124 @@ TEST_F(SerializerDeserializerTests, WriteDataSubmessage)
               deserialized_write_data.data().serialized_data());
 }
 
+TEST_F(SerializerDeserializerTests, WriteDataSubmessageInPlace)
+{
+    dds::xrce::MessageHeader message_header = generate_message_header();
+    dds::xrce::WRITE_DATA_Payload_Data write_payload = generate_write_data_payload();
+    OutputMessage output(message_header);
+    output.append_submessage(dds::xrce::WRITE_DATA, write_payload);
+
+    dds::xrce::BaseObjectRequest deserialized_request;
+    const uint8_t* serialized_data = nullptr;
+    size_t serialized_size = 0;
+    InputMessage input(output.get_buf(), output.get_len());
+    ASSERT_TRUE(input.prepare_next_submessage());
+    ASSERT_TRUE(input.get_payload(deserialized_request));
+    ASSERT_TRUE(input.get_serialized_data(serialized_data, serialized_size));
+
+    ASSERT_EQ(write_payload.request_id(), deserialized_request.request_id());
+    ASSERT_EQ(write_payload.object_id(), deserialized_request.object_id());
+    ASSERT_EQ(write_payload.data().serialized_data(),
+              std::vector<uint8_t>(serialized_data, serialized_data + serialized_size));
+}
+
+TEST_F(SerializerDeserializerTests, WriteDataSeqSubmessageInPlace)
+{
+    dds::xrce::MessageHeader message_header = generate_message_header();
+    dds::xrce::WRITE_DATA_Payload_DataSeq write_payload;
+    write_payload.object_id(object_id);
+    write_payload.request_id(request_id);
+    for (uint8_t i = 1; i <= 3; ++i)
+    {
+        dds::xrce::SampleData sample_data;
+        sample_data.serialized_data(std::vector<uint8_t>(i, i));
+        write_payload.data_seq().push_back(sample_data);
+    }
+    OutputMessage output(message_header);
+    output.append_submessage(dds::xrce::WRITE_DATA, write_payload, dds::xrce::FORMAT_DATA_SEQ_FLAG | 0x01);
+
+    dds::xrce::BaseObjectRequest deserialized_request;
+    uint32_t length = 0;
+    InputMessage input(output.get_buf(), output.get_len());
+    ASSERT_TRUE(input.prepare_next_submessage());
+    ASSERT_EQ(dds::xrce::FORMAT_DATA_SEQ_FLAG, input.get_subheader().flags() & 0x0E);
+    ASSERT_TRUE(input.get_payload(deserialized_request));
+    ASSERT_TRUE(input.get_sequence_length(length));
+    ASSERT_EQ(write_payload.data_seq().size(), length);
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        const uint8_t* serialized_data = nullptr;
+        size_t serialized_size = 0;
+        ASSERT_TRUE(input.get_serialized_data(serialized_data, serialized_size));
+        ASSERT_EQ(write_payload.data_seq()[i].serialized_data(),
+                  std::vector<uint8_t>(serialized_data, serialized_data + serialized_size));
+    }
+}
+
+TEST_F(SerializerDeserializerTests, WritePackedSamplesSubmessageInPlace)
+{
+    dds::xrce::MessageHeader message_header = generate_message_header();
+    dds::xrce::WRITE_DATA_Payload_PackedSamples write_payload;
+    write_payload.object_id(object_id);
+    write_payload.request_id(request_id);
+    write_payload.packed_samples().info_base().sequence_number(0x10);
+    for (uint8_t i = 1; i <= 3; ++i)
+    {
+        dds::xrce::SampleDelta sample_delta;
+        sample_delta.info_delta().seq_number_delta(i);
+        sample_delta.info_delta().timestamp_delta(i);
+        sample_delta.data().serialized_data(std::vector<uint8_t>(i, i));
+        write_payload.packed_samples().sample_delta_seq().push_back(sample_delta);
+    }
+    OutputMessage output(message_header);
+    output.append_submessage(dds::xrce::WRITE_DATA, write_payload, dds::xrce::FORMAT_PACKED_SAMPLES_FLAG | 0x01);
+
+    dds::xrce::BaseObjectRequest deserialized_request;
+    dds::xrce::SampleInfo info_base;
+    uint32_t length = 0;
+    InputMessage input(output.get_buf(), output.get_len());
+    ASSERT_TRUE(input.prepare_next_submessage());
+    ASSERT_TRUE(input.get_payload(deserialized_request));
+    ASSERT_TRUE(input.get_payload(info_base));
+    ASSERT_EQ(0x10u, info_base.sequence_number());
+    ASSERT_TRUE(input.get_sequence_length(length));
+    ASSERT_EQ(write_payload.packed_samples().sample_delta_seq().size(), length);
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        const dds::xrce::SampleDelta& sample_delta = write_payload.packed_samples().sample_delta_seq()[i];
+        dds::xrce::SampleInfoDelta info_delta;
+        const uint8_t* serialized_data = nullptr;
+        size_t serialized_size = 0;
+        ASSERT_TRUE(input.get_payload(info_delta));
+        ASSERT_EQ(sample_delta.info_delta().seq_number_delta(), info_delta.seq_number_delta());
+        ASSERT_EQ(sample_delta.info_delta().timestamp_delta(), info_delta.timestamp_delta());
+        ASSERT_TRUE(input.get_serialized_data(serialized_data, serialized_size));
+        ASSERT_EQ(sample_delta.data().serialized_data(),
+                  std::vector<uint8_t>(serialized_data, serialized_data + serialized_size));
+    }
+}
+
+TEST_F(SerializerDeserializerTests, WriteDataSeqSubmessageBadLength)
+{
+    dds::xrce::MessageHeader message_header = generate_message_header();
+    dds::xrce::WRITE_DATA_Payload_DataSeq write_payload;
+    write_payload.object_id(object_id);
+    write_payload.request_id(request_id);
+    OutputMessage output(message_header);
+    output.append_submessage(dds::xrce::WRITE_DATA, write_payload, dds::xrce::FORMAT_DATA_SEQ_FLAG | 0x01);
+
+    /* Corrupt the sequence length, which is the last field serialized. */
+    std::vector<uint8_t> buffer(output.get_buf(), output.get_buf() + output.get_len());
+    buffer[buffer.size() - 1] = 0xFF;
+
+    dds::xrce::BaseObjectRequest deserialized_request;
+    uint32_t length = 0;
+    InputMessage input(buffer.data(), buffer.size());
+    ASSERT_TRUE(input.prepare_next_submessage());
+    ASSERT_TRUE(input.get_payload(deserialized_request));
+    ASSERT_FALSE(input.get_sequence_length(length));
+}
+
 TEST_F(SerializerDeserializerTests, DataSubmessage)
 {
     dds::xrce::MessageHeader message_header = generate_message_header();